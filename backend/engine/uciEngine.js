@@ -16,12 +16,14 @@ export default class UciEngine extends EventEmitter {
   constructor({
     enginePath,
     depth = 2,
+    multiPV = 1,
     cwd = process.cwd(),
     workersConfigPath = defaultWorkersConfigPath,
   }) {
     super();
     this.enginePath = enginePath ? path.resolve(cwd, enginePath) : "";
     this.depth = depth;
+    this.multiPV = Math.max(1, Math.floor(multiPV) || 1);
     this.cwd = cwd;
     this.workersConfigPath = workersConfigPath
       ? path.resolve(cwd, workersConfigPath)
@@ -36,6 +38,7 @@ export default class UciEngine extends EventEmitter {
       nodes: 0,
       nps: 0,
       pv: [],
+      lines: [],
       bestMove: "--",
       rawScore: null,
     };
@@ -88,6 +91,9 @@ export default class UciEngine extends EventEmitter {
     });
 
     this.sendCommand("uci");
+    if (this.multiPV > 1) {
+      this.sendCommand(`setoption name MultiPV value ${this.multiPV}`);
+    }
     if (
       this.workersConfigPath &&
       fs.existsSync(this.workersConfigPath)
@@ -124,6 +130,7 @@ export default class UciEngine extends EventEmitter {
     }
 
     this.currentAnalysisSide = getSideToMoveFromFen(fen);
+    this.lastAnalysis = { ...this.lastAnalysis, lines: [] };
     this.stop();
     this.sendCommand(`position fen ${fen}`);
     this.sendCommand(`go depth ${depth}`);
@@ -160,12 +167,35 @@ export default class UciEngine extends EventEmitter {
 
     const info = parseInfoLine(line, this.currentAnalysisSide);
     if (info) {
+      const { multipv, ...fields } = info;
+      if (multipv !== null && multipv > 1) {
+        // Secondary MultiPV lines only add an alternative, the headline stays on the best line
+        const lines = [...this.lastAnalysis.lines];
+        lines[multipv - 1] = {
+          evaluation: fields.evaluation,
+          rawScore: fields.rawScore,
+          pv: fields.pv ?? [],
+        };
+        this.lastAnalysis = { ...this.lastAnalysis, lines };
+        this.emit("analysis", this.lastAnalysis);
+        return;
+      }
+
       this.lastAnalysis = {
         ...this.lastAnalysis,
         ...Object.fromEntries(
-          Object.entries(info).filter(([, value]) => value !== null)
+          Object.entries(fields).filter(([, value]) => value !== null)
         ),
       };
+      if (multipv === 1) {
+        const lines = [...this.lastAnalysis.lines];
+        lines[0] = {
+          evaluation: this.lastAnalysis.evaluation,
+          rawScore: this.lastAnalysis.rawScore,
+          pv: this.lastAnalysis.pv,
+        };
+        this.lastAnalysis = { ...this.lastAnalysis, lines };
+      }
       this.emit("analysis", this.lastAnalysis);
       return;
     }
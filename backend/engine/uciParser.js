@@ -33,6 +33,7 @@ export function parseInfoLine(line, sideToMove = "w") {
 
   const info = {
     depth: null,
+    multipv: null,
     nodes: null,
     nps: null,
     pv: null,
@@ -49,6 +50,12 @@ export function parseInfoLine(line, sideToMove = "w") {
       continue;
     }
 
+    if (token === "multipv" && tokens[index + 1]) {
+      info.multipv = Number(tokens[index + 1]);
+      index += 1;
+      continue;
+    }
+
     if (token === "nodes" && tokens[index + 1]) {
       info.nodes = Number(tokens[index + 1]);
       index += 1;
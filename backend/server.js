@@ -9,6 +9,7 @@ import UciEngine from "./engine/uciEngine.js";
 
 const PORT = Number(process.env.PORT ?? 3001);
 const ENGINE_DEPTH = Number(process.env.ENGINE_DEPTH ?? 15);
+const ENGINE_MULTIPV = Number(process.env.ENGINE_MULTIPV ?? 1);
 const ENGINE_PATH = process.env.ENGINE_PATH ?? "../build/engine";
 const backendRoot = path.dirname(fileURLToPath(import.meta.url));
 
@@ -22,6 +23,7 @@ const wss = new WebSocketServer({ server });
 const engine = new UciEngine({
   enginePath: ENGINE_PATH,
   depth: ENGINE_DEPTH,
+  multiPV: ENGINE_MULTIPV,
   cwd: backendRoot,
 });
 
@@ -8,7 +8,7 @@ import json
 import re
 import sys
 from collections import defaultdict
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from pathlib import Path
 
 
@@ -30,6 +30,24 @@ EXPECTED_FIELDS = (
     "completed_depth",
 )
 
+OPTIONAL_FIELDS = (
+    "eval_cache_hits",
+    "eval_cache_misses",
+    "beta_cutoffs",
+    "first_move_cutoffs",
+    "cutoff_move_index_sum",
+)
+
+# Search tree statistics (the engine's "Search Stats" option): comma separated counts, summed element-wise
+OPTIONAL_LIST_FIELDS = (
+    "cutoffs_by_depth",
+    "first_move_cutoffs_by_depth",
+    "qnodes_by_qdepth",
+    "iteration_nodes",
+)
+
+OPTIONAL_FLOAT_FIELDS = ("ebf",)
+
 EXPECTED_DIST_WORKER_FIELDS = (
     "endpoint",
     "mode",
@@ -68,6 +86,17 @@ class GameInfo:
     result: str | None = None
 
 
+def add_counts(total: list[int], counts: list[int]) -> None:
+    if len(total) < len(counts):
+        total.extend([0] * (len(counts) - len(total)))
+    for index, count in enumerate(counts):
+        total[index] += count
+
+
+def join_counts(counts: list[int]) -> str:
+    return ";".join(str(count) for count in counts)
+
+
 @dataclass
 class Aggregate:
     searches: int = 0
@@ -78,9 +107,19 @@ class Aggregate:
     tt_misses: int = 0
     tt_writes: int = 0
     tt_rewrites: int = 0
+    eval_cache_hits: int = 0
+    eval_cache_misses: int = 0
     completed_depth_sum: int = 0
-
-    def add(self, fields: dict[str, int]) -> None:
+    beta_cutoffs: int = 0
+    first_move_cutoffs: int = 0
+    cutoff_move_index_sum: int = 0
+    ebf_sum: float = 0.0
+    ebf_searches: int = 0
+    cutoffs_by_depth: list[int] = field(default_factory=list)
+    first_move_cutoffs_by_depth: list[int] = field(default_factory=list)
+    qnodes_by_qdepth: list[int] = field(default_factory=list)
+
+    def add(self, fields: dict) -> None:
         self.searches += 1
         self.nodes += fields["nodes"]
         self.qnodes += fields["qnodes"]
@@ -89,7 +128,18 @@ class Aggregate:
         self.tt_misses += fields["tt_misses"]
         self.tt_writes += fields["tt_writes"]
         self.tt_rewrites += fields["tt_rewrites"]
+        self.eval_cache_hits += fields["eval_cache_hits"]
+        self.eval_cache_misses += fields["eval_cache_misses"]
         self.completed_depth_sum += fields["completed_depth"]
+        self.beta_cutoffs += fields["beta_cutoffs"]
+        self.first_move_cutoffs += fields["first_move_cutoffs"]
+        self.cutoff_move_index_sum += fields["cutoff_move_index_sum"]
+        if fields["ebf"] > 0:
+            self.ebf_sum += fields["ebf"]
+            self.ebf_searches += 1
+        add_counts(self.cutoffs_by_depth, fields["cutoffs_by_depth"])
+        add_counts(self.first_move_cutoffs_by_depth, fields["first_move_cutoffs_by_depth"])
+        add_counts(self.qnodes_by_qdepth, fields["qnodes_by_qdepth"])
 
     def merge(self, other: "Aggregate") -> None:
         self.searches += other.searches
@@ -100,16 +150,31 @@ class Aggregate:
         self.tt_misses += other.tt_misses
         self.tt_writes += other.tt_writes
         self.tt_rewrites += other.tt_rewrites
+        self.eval_cache_hits += other.eval_cache_hits
+        self.eval_cache_misses += other.eval_cache_misses
         self.completed_depth_sum += other.completed_depth_sum
+        self.beta_cutoffs += other.beta_cutoffs
+        self.first_move_cutoffs += other.first_move_cutoffs
+        self.cutoff_move_index_sum += other.cutoff_move_index_sum
+        self.ebf_sum += other.ebf_sum
+        self.ebf_searches += other.ebf_searches
+        add_counts(self.cutoffs_by_depth, other.cutoffs_by_depth)
+        add_counts(self.first_move_cutoffs_by_depth, other.first_move_cutoffs_by_depth)
+        add_counts(self.qnodes_by_qdepth, other.qnodes_by_qdepth)
 
     def as_row(self) -> dict[str, str]:
         total_nodes = self.nodes + self.qnodes
         tt_accesses = self.tt_hits + self.tt_misses
         tt_writes_total = self.tt_writes + self.tt_rewrites
+        eval_cache_accesses = self.eval_cache_hits + self.eval_cache_misses
         avg_depth = self.completed_depth_sum / self.searches if self.searches else 0.0
         nps = (1000.0 * total_nodes / self.elapsed_ms) if self.elapsed_ms else 0.0
         hit_rate = (100.0 * self.tt_hits / tt_accesses) if tt_accesses else 0.0
         rewrite_rate = (100.0 * self.tt_rewrites / tt_writes_total) if tt_writes_total else 0.0
+        eval_cache_hit_rate = (100.0 * self.eval_cache_hits / eval_cache_accesses) if eval_cache_accesses else 0.0
+        first_move_cutoff_rate = (100.0 * self.first_move_cutoffs / self.beta_cutoffs) if self.beta_cutoffs else 0.0
+        avg_cutoff_move_index = (self.cutoff_move_index_sum / self.beta_cutoffs) if self.beta_cutoffs else 0.0
+        avg_ebf = (self.ebf_sum / self.ebf_searches) if self.ebf_searches else 0.0
 
         return {
             "searches": str(self.searches),
@@ -123,7 +188,18 @@ class Aggregate:
             "tt_writes": str(self.tt_writes),
             "tt_rewrites": str(self.tt_rewrites),
             "tt_rewrite_rate_pct": f"{rewrite_rate:.2f}",
+            "eval_cache_hits": str(self.eval_cache_hits),
+            "eval_cache_misses": str(self.eval_cache_misses),
+            "eval_cache_hit_rate_pct": f"{eval_cache_hit_rate:.2f}",
             "avg_completed_depth": f"{avg_depth:.2f}",
+            "beta_cutoffs": str(self.beta_cutoffs),
+            "first_move_cutoffs": str(self.first_move_cutoffs),
+            "first_move_cutoff_pct": f"{first_move_cutoff_rate:.2f}",
+            "avg_cutoff_move_index": f"{avg_cutoff_move_index:.3f}",
+            "avg_ebf": f"{avg_ebf:.2f}",
+            "cutoffs_by_depth": join_counts(self.cutoffs_by_depth),
+            "first_move_cutoffs_by_depth": join_counts(self.first_move_cutoffs_by_depth),
+            "qnodes_by_qdepth": join_counts(self.qnodes_by_qdepth),
         }
 
 
@@ -254,15 +330,25 @@ def resolve_log_path(input_path: Path) -> Path:
     return input_path
 
 
-def parse_payload(payload: str) -> dict[str, int]:
-    fields: dict[str, int] = {}
+def parse_payload(payload: str) -> dict:
+    fields: dict = {}
     for token in payload.split():
         if "=" not in token:
             continue
         key, value = token.split("=", 1)
-        if key not in EXPECTED_FIELDS:
-            continue
-        fields[key] = int(value)
+        if key in OPTIONAL_LIST_FIELDS:
+            fields[key] = [int(count) for count in value.split(",")]
+        elif key in OPTIONAL_FLOAT_FIELDS:
+            fields[key] = float(value)
+        elif key in EXPECTED_FIELDS or key in OPTIONAL_FIELDS:
+            fields[key] = int(value)
+
+    for field in OPTIONAL_FIELDS:
+        fields.setdefault(field, 0)
+    for field in OPTIONAL_LIST_FIELDS:
+        fields.setdefault(field, [])
+    for field in OPTIONAL_FLOAT_FIELDS:
+        fields.setdefault(field, 0.0)
 
     missing = [field for field in EXPECTED_FIELDS if field not in fields]
     if missing:
@@ -469,7 +555,18 @@ def main() -> int:
             "tt_writes",
             "tt_rewrites",
             "tt_rewrite_rate_pct",
+            "eval_cache_hits",
+            "eval_cache_misses",
+            "eval_cache_hit_rate_pct",
             "avg_completed_depth",
+            "beta_cutoffs",
+            "first_move_cutoffs",
+            "first_move_cutoff_pct",
+            "avg_cutoff_move_index",
+            "avg_ebf",
+            "cutoffs_by_depth",
+            "first_move_cutoffs_by_depth",
+            "qnodes_by_qdepth",
             "worker_reports",
             "coordinator_reports",
             "remote_reports",
@@ -512,7 +609,18 @@ def main() -> int:
             "tt_writes",
             "tt_rewrites",
             "tt_rewrite_rate_pct",
+            "eval_cache_hits",
+            "eval_cache_misses",
+            "eval_cache_hit_rate_pct",
             "avg_completed_depth",
+            "beta_cutoffs",
+            "first_move_cutoffs",
+            "first_move_cutoff_pct",
+            "avg_cutoff_move_index",
+            "avg_ebf",
+            "cutoffs_by_depth",
+            "first_move_cutoffs_by_depth",
+            "qnodes_by_qdepth",
             "worker_reports",
             "coordinator_reports",
             "remote_reports",
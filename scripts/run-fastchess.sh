@@ -21,6 +21,7 @@ ROUNDS="${ROUNDS:-25}"
 CONCURRENCY="${CONCURRENCY:-4}"
 BOOK_PLIES="${BOOK_PLIES:-10}"
 WRITE_LOGS="${WRITE_LOGS:-0}"
+PONDER="${PONDER:-0}"
 
 command -v "${FASTCHESS_BIN}" >/dev/null || { echo "missing fastchess: ${FASTCHESS_BIN}" >&2; exit 1; }
 [[ -x "${ENGINE_CMD}" ]] || { echo "missing engine binary: ${ENGINE_CMD}" >&2; exit 1; }
@@ -40,6 +41,11 @@ args=(
   -show-latency
 )
 
+# Lets the engines think on the opponent's time (`go ponder` / `ponderhit`)
+if [[ "${PONDER}" != "0" ]]; then
+  args+=(-pondering)
+fi
+
 if [[ "${WRITE_LOGS}" != "0" ]]; then
   args+=(
     -pgnout "file=games.pgn" timeleft=true latency=true
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string_view>
+
+#include "types.h"
+
+namespace engine {
+
+struct BenchOptions {
+    static constexpr Depth kDefaultDepth = 6;
+    static constexpr int kDefaultThreads = 1;
+    static constexpr size_t kDefaultHashMb = 16;
+
+    Depth depth{kDefaultDepth};
+    int threads{kDefaultThreads};
+    size_t hashMb{kDefaultHashMb};
+};
+
+struct BenchResult {
+    uint64_t nodes{};  // Regular + quiescence nodes over all positions, the bench signature
+    uint64_t elapsedMs{};
+
+    uint64_t nps() const noexcept { return elapsedMs == 0 ? nodes : (1000 * nodes) / elapsedMs; }
+};
+
+// The fixed bench positions, also used as a corpus of realistic positions by `tools/micro_bench.cpp`.
+std::span<const std::string_view> bench_positions() noexcept;
+
+// Searches a fixed list of positions to a fixed depth, each with a cleared transposition table and fresh search
+// heuristics, printing per-position node counts and the totals to `out`.
+// With one thread the node count is deterministic, so it identifies the search behaviour of a build.
+BenchResult run_bench(const BenchOptions& options, std::ostream& out);
+
+}  // namespace engine
@@ -12,6 +12,7 @@
 #include <charconv>
 #include <chrono>
 #include <cstring>
+#include <format>
 #include <optional>
 #include <fstream>
 #include <sstream>
@@ -24,6 +25,7 @@
 
 #include "engine.h"
 #include "move_gen/generator.h"
+#include "trace.h"
 #include "transposition_table.h"
 #include "util.h"
 
@@ -572,6 +574,8 @@ std::string buildResponseMessage(const WorkerResponse& response) {
     oss << "tt_misses " << response.ttStats.misses << '\n';
     oss << "tt_writes " << response.ttStats.writes << '\n';
     oss << "tt_rewrites " << response.ttStats.rewrites << '\n';
+    oss << "eval_cache_hits " << response.result.telemetry.evalCacheHits << '\n';
+    oss << "eval_cache_misses " << response.result.telemetry.evalCacheMisses << '\n';
     for (const SearchResult& iteration : response.completedIterations) {
         oss << "iter"
             << " depth=" << iteration.telemetry.completedDepth
@@ -698,6 +702,14 @@ bool parseResponse(
             if (!parseInteger(value, ttStats.rewrites))
                 return false;
         }
+        else if (key == "eval_cache_hits") {
+            if (!parseInteger(value, result.telemetry.evalCacheHits))
+                return false;
+        }
+        else if (key == "eval_cache_misses") {
+            if (!parseInteger(value, result.telemetry.evalCacheMisses))
+                return false;
+        }
         else if (key == "iter") {
             SearchResult iteration{};
             std::string pvCsv;
@@ -1036,10 +1048,13 @@ SearchResult runDistributedRootSplitSearch(
     SearchSharedState* sharedState,
     const std::vector<DistributedWorkerEndpoint>& endpoints,
     DistributedCoordinatorSessions* sessions,
-    std::vector<DistributedWorkerReport>* reports
+    std::vector<DistributedWorkerReport>* reports,
+    std::span<const Move> rootMoves
 ) {
     MoveList legalMoves(root);
     std::vector<Move> allRootMoves(legalMoves.begin(), legalMoves.end());
+    if (!rootMoves.empty())
+        allRootMoves.assign(rootMoves.begin(), rootMoves.end());
     if (allRootMoves.empty()) {
         TTStats ttStats{};
         return searchLocalSubset(root, limits, positionHistory, hashMb, sharedState, allRootMoves, nullptr, &ttStats);
@@ -1047,6 +1062,7 @@ SearchResult runDistributedRootSplitSearch(
 
     const size_t participantCount = std::min(endpoints.size() + 1, allRootMoves.size());
     const size_t remoteWorkerCount = participantCount > 0 ? std::min(endpoints.size(), participantCount - 1) : 0;
+    const TraceScope distributedScope("distributed_search", "participants", static_cast<int64_t>(participantCount));
 
     std::vector<std::vector<Move>> assignments(participantCount);
     for (size_t i = 0; i < allRootMoves.size(); ++i)
@@ -1092,6 +1108,7 @@ SearchResult runDistributedRootSplitSearch(
         if (!session.socket.valid()) {
             if (session.everConnected)
                 ++session.reconnectCount;
+            const TraceScope connectScope("connect_worker", "worker", static_cast<int64_t>(remoteIndex));
             session.socket = connectToWorker(endpoints[remoteIndex]);
             session.available = session.socket.valid();
             session.failed = !session.available;
@@ -1111,6 +1128,10 @@ SearchResult runDistributedRootSplitSearch(
 
     workers.emplace_back([&]() {
         constexpr size_t coordinatorIndex = 0;
+        set_trace_thread_name("coordinator participant");
+        const TraceScope participantScope(
+            "coordinator_search", "root_moves", static_cast<int64_t>(assignments[coordinatorIndex].size())
+        );
         localReports[coordinatorIndex].endpoint = DistributedWorkerEndpoint{
             .host = "coordinator",
             .port = 0,
@@ -1142,6 +1163,12 @@ SearchResult runDistributedRootSplitSearch(
     for (size_t remoteIndex = 0; remoteIndex < remoteWorkerCount; ++remoteIndex) {
         workers.emplace_back([&, remoteIndex]() {
             const size_t resultIndex = remoteIndex + 1;
+            set_trace_thread_name(
+                std::format("remote participant {}:{}", endpoints[remoteIndex].host, endpoints[remoteIndex].port)
+            );
+            const TraceScope participantScope(
+                "remote_participant", "root_moves", static_cast<int64_t>(assignments[resultIndex].size())
+            );
             const auto now = std::chrono::steady_clock::now();
             const auto remainingSoft =
                 sharedState != nullptr && sharedState->softDeadline.has_value()
@@ -1188,13 +1215,17 @@ SearchResult runDistributedRootSplitSearch(
             localReports[resultIndex].sessionRequestCount = remoteSession.requestCount + 1;
             localReports[resultIndex].sessionReconnectCount = remoteSession.reconnectCount;
 
-            if (remoteSession.available && !writeAll(remoteSession.socket.value, buildRequestMessage(request))) {
-                remoteSession.available = false;
-                remoteSession.failed = true;
-                remoteSession.socket.reset();
+            if (remoteSession.available) {
+                const TraceScope sendScope("send_request");
+                if (!writeAll(remoteSession.socket.value, buildRequestMessage(request))) {
+                    remoteSession.available = false;
+                    remoteSession.failed = true;
+                    remoteSession.socket.reset();
+                }
             }
 
             if (!remoteSession.available) {
+                const TraceScope fallbackScope("local_fallback");
                 participantResults[resultIndex] = searchLocalSubset(
                     *(*localTables)[resultIndex],
                     root,
@@ -1220,10 +1251,16 @@ SearchResult runDistributedRootSplitSearch(
             WorkerResponse response;
             std::atomic<bool> stopSent{false};
             const auto roundTripStart = std::chrono::steady_clock::now();
-            if (!parseResponse(remoteSession.socket.value, root, sharedState, stopSent, response)) {
+            bool responseReceived = false;
+            {
+                const TraceScope awaitScope("await_response");
+                responseReceived = parseResponse(remoteSession.socket.value, root, sharedState, stopSent, response);
+            }
+            if (!responseReceived) {
                 remoteSession.available = false;
                 remoteSession.failed = true;
                 remoteSession.socket.reset();
+                const TraceScope fallbackScope("local_fallback");
                 participantResults[resultIndex] = searchLocalSubset(
                     *(*localTables)[resultIndex],
                     root,
@@ -1266,11 +1303,15 @@ SearchResult runDistributedRootSplitSearch(
         });
     }
 
-    for (std::thread& worker : workers) {
-        if (worker.joinable())
-            worker.join();
+    {
+        const TraceScope joinScope("join_participants");
+        for (std::thread& worker : workers) {
+            if (worker.joinable())
+                worker.join();
+        }
     }
 
+    const TraceScope mergeScope("merge_participants");
     auto findIterationAtDepth = [](const std::vector<SearchResult>& iterations, Depth depth) -> const SearchResult* {
         const auto it = std::ranges::find_if(
             iterations,
@@ -1336,6 +1377,8 @@ SearchResult runDistributedRootSplitSearch(
         aggregate.telemetry.ttMisses += participantResults[i].telemetry.ttMisses;
         aggregate.telemetry.ttWrites += participantResults[i].telemetry.ttWrites;
         aggregate.telemetry.ttRewrites += participantResults[i].telemetry.ttRewrites;
+        aggregate.telemetry.evalCacheHits += participantResults[i].telemetry.evalCacheHits;
+        aggregate.telemetry.evalCacheMisses += participantResults[i].telemetry.evalCacheMisses;
         aggregate.stopped = aggregate.stopped || participantResults[i].stopped;
 
         if (sharedDepth > 0 && localReports[i].result.telemetry.completedDepth >= sharedDepth)
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -53,7 +54,8 @@ private:
         SearchSharedState* sharedState,
         const std::vector<DistributedWorkerEndpoint>& endpoints,
         DistributedCoordinatorSessions* sessions,
-        std::vector<DistributedWorkerReport>* reports
+        std::vector<DistributedWorkerReport>* reports,
+        std::span<const Move> rootMoves
     );
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -78,7 +80,8 @@ SearchResult runDistributedRootSplitSearch(
     SearchSharedState* sharedState,
     const std::vector<DistributedWorkerEndpoint>& endpoints,
     DistributedCoordinatorSessions* sessions = nullptr,
-    std::vector<DistributedWorkerReport>* reports = nullptr
+    std::vector<DistributedWorkerReport>* reports = nullptr,
+    std::span<const Move> rootMoves = {}  // Splits these root moves instead of all legal ones when not empty
 );
 
 int runDistributedWorkerServer(std::string_view bindHost, uint16_t port);
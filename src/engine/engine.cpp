@@ -2,9 +2,12 @@
 
 #include <algorithm>
 #include <cctype>
+#include <format>
+#include <fstream>
 #include <iostream>
 #include <utility>
 
+#include "trace.h"
 #include "uciengine.h"
 #include "util.h"
 
@@ -30,13 +33,13 @@ void printUciScore(Eval score) {
         std::cout << "score cp " << score;
 }
 
-void printUciPV(const SearchResult& result) {
-    if (result.pvLength == 0)
+void printUciPV(std::span<const Move> pv) {
+    if (pv.empty())
         return;
 
     std::cout << " pv";
-    for (uint8_t i = 0; i < result.pvLength; ++i) {
-        std::cout << ' ' << to_string(result.pv[i]);
+    for (const Move move : pv) {
+        std::cout << ' ' << to_string(move);
     }
 }
 
@@ -50,6 +53,51 @@ std::string summarizeRootMoves(const std::vector<Move>& moves) {
     return out;
 }
 
+// Comma separated counts, without the trailing empty buckets.
+std::string joinCounts(std::span<const uint64_t> counts) {
+    const auto last = std::ranges::find_if(counts.rbegin(), counts.rend(), [](uint64_t n) { return n != 0; });
+    const auto used = static_cast<size_t>(std::distance(last, counts.rend()));
+    std::string out;
+    for (size_t i = 0; i < used; ++i) {
+        if (i != 0)
+            out += ',';
+        out += std::to_string(counts[i]);
+    }
+    return out.empty() ? "0" : out;
+}
+
+// Tree statistics fields of the telemetry line. Depth-indexed lists start at depth 0.
+std::string formatTreeStats(const SearchTreeStats& stats) {
+    return std::format(
+        " beta_cutoffs={} first_move_cutoffs={} cutoff_move_index_sum={} ebf={:.2f} cutoffs_by_depth={}"
+        " first_move_cutoffs_by_depth={} qnodes_by_qdepth={} iteration_nodes={}",
+        stats.totalBetaCutoffs(),
+        stats.totalFirstMoveCutoffs(),
+        stats.cutoffMoveIndexSum,
+        stats.effectiveBranchingFactor(),
+        joinCounts(stats.betaCutoffs),
+        joinCounts(stats.firstMoveCutoffs),
+        joinCounts(stats.qDepthNodes),
+        joinCounts(stats.iterationNodes)
+    );
+}
+
+// Completes a PV that a TT cutoff ended right after the best move with the stored reply, so there is a move to ponder on.
+void extendPVFromTT(const Position& root, SearchResult& result, const TranspositionTable& tt) {
+    if (result.pvLength != 1)
+        return;
+
+    Position pos = root;
+    UndoInfo u{};
+    pos.makeMove(result.pv[0], u);
+    const auto hit = tt.probe(pos.hash());
+    if (!hit.has_value() || hit->bestMove.isNone() || !MoveList(pos).contains(hit->bestMove))
+        return;
+
+    result.pv[1] = hit->bestMove;
+    result.pvLength = 2;
+}
+
 std::string formatWorkerEndpoint(const DistributedWorkerReport& report) {
     if (report.coordinatorParticipant)
         return "coordinator";
@@ -92,7 +140,16 @@ bool shouldUseDistributedSearch(
     const std::vector<DistributedWorkerEndpoint>& distributedWorkers,
     size_t legalMoveCount
 ) noexcept {
-    if (distributedWorkers.empty() || limits.infinite)
+    // Node-limited searches stay local, so their node count is reproducible
+    if (distributedWorkers.empty() || limits.infinite || limits.nodes.has_value())
+        return false;
+
+    // Remote workers only know fixed deadlines, which a ponder search must be able to lift
+    if (sharedState.pondering.load(std::memory_order_relaxed))
+        return false;
+
+    // The root split gives every participant different root moves, so none could rank the lines of the others
+    if (limits.multiPV > 1)
         return false;
 
     const size_t participantCount = distributedWorkers.size() + 1;
@@ -135,13 +192,18 @@ SearchResult runParallelSearch(
     std::vector<SearchResult>* completedIterations
 ) {
     const int threadCount = std::max(1, limits.threads);
+    if (sharedSearchState != nullptr)
+        sharedSearchState->nodesSearched.store(0, std::memory_order_relaxed);
     std::vector<SearchResult> workerResults(static_cast<size_t>(threadCount));
     std::vector<std::vector<SearchResult>> workerIterationResults(static_cast<size_t>(threadCount));
     std::vector<std::thread> workers;
     workers.reserve(static_cast<size_t>(threadCount));
+    const TraceScope parallelScope("parallel_search", "threads", threadCount);
 
     for (int workerId = 0; workerId < threadCount; ++workerId) {
         workers.emplace_back([&, workerId]() {
+            set_trace_thread_name(std::format("search worker {}", workerId));
+            const TraceScope workerScope("worker_search", "worker", workerId);
             Position workerRoot = root;
             Search worker(tt, sharedSearchState, workerId, positionHistory);
             if (completedIterations != nullptr) {
@@ -155,11 +217,15 @@ SearchResult runParallelSearch(
         });
     }
 
-    for (std::thread& worker : workers) {
-        if (worker.joinable())
-            worker.join();
+    {
+        const TraceScope joinScope("join_workers");
+        for (std::thread& worker : workers) {
+            if (worker.joinable())
+                worker.join();
+        }
     }
 
+    const TraceScope mergeScope("merge_results");
     SearchResult aggregate{};
     if (!workerResults.empty())
         aggregate = workerResults[0];
@@ -169,10 +235,16 @@ SearchResult runParallelSearch(
 
     aggregate.telemetry.nodes = 0;
     aggregate.telemetry.qNodes = 0;
+    aggregate.telemetry.evalCacheHits = 0;
+    aggregate.telemetry.evalCacheMisses = 0;
+    aggregate.telemetry.treeStats = {};
     aggregate.stopped = false;
     for (const SearchResult& workerResult : workerResults) {
         aggregate.telemetry.nodes += workerResult.telemetry.nodes;
         aggregate.telemetry.qNodes += workerResult.telemetry.qNodes;
+        aggregate.telemetry.evalCacheHits += workerResult.telemetry.evalCacheHits;
+        aggregate.telemetry.evalCacheMisses += workerResult.telemetry.evalCacheMisses;
+        aggregate.telemetry.treeStats.merge(workerResult.telemetry.treeStats);
         aggregate.stopped = aggregate.stopped || workerResult.stopped;
     }
 
@@ -215,6 +287,11 @@ Engine::Engine() {
         UCIOption::spin("Hash", kDefaultHashMb, 1, 65536),
         UCIOption::spin("Default Depth", kDefaultDepth, 1, 255),
         UCIOption::spin("Threads", kDefaultThreads, 1, 1024),
+        UCIOption::spin("MultiPV", 1, 1, kMaxMultiPV),
+        UCIOption::check("Ponder", false),
+        UCIOption::check("Perf Counters", false),
+        UCIOption::check("Search Stats", false),
+        UCIOption::string("Trace File", ""),
         UCIOption::string("Distributed_Workers", ""),
         UCIOption::string("Distributed_Workers_Config", "")
     };
@@ -261,6 +338,16 @@ void Engine::applyOption_(const UCIOption& option) {
         searchLimits_.depth = static_cast<uint8_t>(option.getValue<int>());
     else if (option.key() == "threads")
         searchLimits_.threads = option.getValue<int>();
+    else if (option.key() == "multipv")
+        searchLimits_.multiPV = option.getValue<int>();
+    else if (option.key() == "perf counters")
+        perfCounters_ = option.getValue<bool>();
+    else if (option.key() == "search stats")
+        searchLimits_.treeStats = option.getValue<bool>();
+    else if (option.key() == "trace file") {
+        traceFile_ = option.getValue<std::string>();
+        set_tracing(!traceFile_.empty());
+    }
     else if (option.key() == "distributed workers") {
         std::vector<DistributedWorkerEndpoint> endpoints;
         std::string error;
@@ -311,28 +398,39 @@ void Engine::startSearch_(
     std::optional<Depth> depthOverride,
     bool infinite,
     std::optional<std::chrono::milliseconds> moveTime,
-    std::optional<SearchLimits::TimeControl> timeControl
+    std::optional<SearchLimits::TimeControl> timeControl,
+    std::optional<uint64_t> nodes,
+    bool ponder,
+    std::vector<Move> searchMoves
 ) {
     stopSearch_();
 
-    const bool timeManagedSearch = moveTime.has_value() || timeControl.has_value();
+    const bool limitedSearch = moveTime.has_value() || timeControl.has_value() || nodes.has_value() || ponder;
     const Depth requestedDepth =
-        depthOverride.value_or(timeManagedSearch ? static_cast<Depth>(kMaxPly - 1) : searchLimits_.depth);
+        depthOverride.value_or(limitedSearch ? static_cast<Depth>(kMaxPly - 1) : searchLimits_.depth);
 
     const SearchLimits limits{
         .depth = requestedDepth,
         .threads = searchLimits_.threads,
         .infinite = infinite,
         .moveTime = moveTime,
-        .timeControl = timeControl
+        .nodes = nodes,
+        .timeControl = timeControl,
+        .treeStats = searchLimits_.treeStats,
+        .multiPV = searchLimits_.multiPV
     };
 
     const Position root = position_;
+    if (!traceFile_.empty())
+        clear_trace();
     tt_.resetCounters();
     tt_.newSearch();
     const TimeBudget timeBudget = buildTimeBudget(limits, root.sideToMove());
 
+    // A ponder search already runs against the time budget of the predicted position, so `ponderhit` credits the time
+    // spent pondering by just lifting the ponder flag
     sharedSearchState_.stopRequested.store(false, std::memory_order_relaxed);
+    sharedSearchState_.pondering.store(ponder, std::memory_order_relaxed);
     if (timeBudget.softLimit.has_value())
         sharedSearchState_.softDeadline = std::chrono::steady_clock::now() + *timeBudget.softLimit;
     else
@@ -342,13 +440,26 @@ void Engine::startSearch_(
     else
         sharedSearchState_.hardDeadline.reset();
 
-    searchThread_ = std::thread([this, root = root, limits]() mutable {
+    searchThread_ = std::thread([this, root = root, limits, searchMoves = std::move(searchMoves)]() mutable {
+        set_trace_thread_name("uci search");
+        // Opened on the search thread, so the counters are inherited by the worker threads it spawns
+        std::optional<PerfCounters> perfCounters;
+        if (perfCounters_)
+            perfCounters.emplace();
+
         const auto start = std::chrono::steady_clock::now();
-        SearchResult result = runSearch_(root, limits);
+        SearchResult result = runSearch_(root, limits, searchMoves);
         const auto end = std::chrono::steady_clock::now();
         const auto elapsedMs =
             static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
         const TTStats ttStats = tt_.stats();
+        extendPVFromTT(root, result, tt_);
+
+        // The best move must not be sent while pondering, even if the search already finished
+        if (sharedSearchState_.pondering.load(std::memory_order_acquire)) {
+            std::unique_lock lock(ponderMutex_);
+            ponderCv_.wait(lock, [this] { return !sharedSearchState_.pondering.load(std::memory_order_acquire); });
+        }
 
         result.telemetry.elapsedMs = elapsedMs;
         result.telemetry.ttHits = ttStats.hits;
@@ -356,21 +467,71 @@ void Engine::startSearch_(
         result.telemetry.ttWrites = ttStats.writes;
         result.telemetry.ttRewrites = ttStats.rewrites;
 
+        lastPerfCounters_.clear();
+        if (perfCounters.has_value()) {
+            const uint64_t totalNodes = result.telemetry.nodes + result.telemetry.qNodes;
+            lastPerfCounters_ = perfCounters->available()
+                ? format_perf_counters(perfCounters->read(), totalNodes)
+                : "unavailable (" + perfCounters->error() + ")";
+        }
+
         printSearchResult_(limits, result, elapsedMs);
+        if (!traceFile_.empty())
+            writeTrace_();
     });
 }
 
+// Exports the timeline of the search that just finished, replacing the previous trace file.
+void Engine::writeTrace_() const {
+    std::ofstream out(traceFile_);
+    if (out)
+        write_chrome_trace(out);
+    if (!out) {
+        std::cout << "info string Failed to write trace file: " << traceFile_ << '\n';
+        std::cout.flush();
+    }
+}
+
 void Engine::stopSearch_() {
     sharedSearchState_.stopRequested.store(true, std::memory_order_relaxed);
+    ponderHit_();
     if (searchThread_.joinable())
         searchThread_.join();
 }
 
-SearchResult Engine::runSearch_(const Position& root, const SearchLimits& limits) {
+// Turns a ponder search into a normal search of the same position. Does nothing unless pondering.
+void Engine::ponderHit_() {
+    {
+        const std::scoped_lock lock(ponderMutex_);
+        sharedSearchState_.pondering.store(false, std::memory_order_release);
+    }
+    ponderCv_.notify_all();
+}
+
+// Prints the leaf count below each root move followed by the total, using the Threads option for the root split and a
+// perft table as large as the Hash option. Runs synchronously, as perft cannot be stopped.
+void Engine::runPerft_(Depth depth) {
+    stopSearch_();
+
+    PerftTable table(static_cast<size_t>(option_("Hash").getValue<int>()));
+    const PerftResult result = run_perft(position_, depth, searchLimits_.threads, &table);
+
+    for (const auto& [move, nodes] : result.divide)
+        std::cout << to_string(move) << ": " << nodes << '\n';
+    std::cout << "\nNodes searched: " << result.nodes << '\n';
+    std::cout << "info string perft depth " << depth << " nodes " << result.nodes
+              << " time " << std::chrono::duration_cast<std::chrono::milliseconds>(result.elapsed).count()
+              << " nps " << result.nps() << '\n';
+    std::cout.flush();
+}
+
+// Searches all legal root moves, or only `rootMoves` when it is not empty (`go searchmoves`).
+SearchResult Engine::runSearch_(const Position& root, const SearchLimits& limits, std::span<const Move> rootMoves) {
     lastDistributedReports_.clear();
     MoveList legalMoves(root);
+    const size_t rootMoveCount = rootMoves.empty() ? legalMoves.size() : rootMoves.size();
 
-    if (shouldUseDistributedSearch(limits, sharedSearchState_, distributedWorkers_, legalMoves.size())) {
+    if (shouldUseDistributedSearch(limits, sharedSearchState_, distributedWorkers_, rootMoveCount)) {
         return runDistributedRootSplitSearch(
             root,
             limits,
@@ -379,10 +540,11 @@ SearchResult Engine::runSearch_(const Position& root, const SearchLimits& limits
             &sharedSearchState_,
             distributedWorkers_,
             &distributedCoordinatorSessions_,
-            &lastDistributedReports_
+            &lastDistributedReports_,
+            rootMoves
         );
     }
-    return runParallelSearch(root, limits, positionHistory_, &tt_, &sharedSearchState_);
+    return runParallelSearch(root, limits, positionHistory_, &tt_, &sharedSearchState_, rootMoves);
 }
 
 void Engine::mergeSearchResult_(SearchResult& aggregate, const SearchResult& workerResult, bool preferWorker) {
@@ -394,11 +556,23 @@ void Engine::printSearchResult_(const SearchLimits& limits, const SearchResult&
     const auto nps = elapsedMs == 0 ? totalNodes : (1000 * totalNodes) / elapsedMs;
     const Depth reportedDepth =
         result.telemetry.completedDepth > 0 ? result.telemetry.completedDepth : std::min<Depth>(limits.depth, 1);
-    std::cout << "info depth " << reportedDepth << ' ';
-    printUciScore(result.score);
-    std::cout << " nodes " << totalNodes << " time " << elapsedMs << " nps " << nps;
-    printUciPV(result);
-    std::cout << '\n';
+    if (result.lines.size() > 1) {
+        for (size_t i = 0; i < result.lines.size(); ++i) {
+            const RootLine& line = result.lines[i];
+            std::cout << "info depth " << reportedDepth << " multipv " << i + 1 << ' ';
+            printUciScore(line.score);
+            std::cout << " nodes " << totalNodes << " time " << elapsedMs << " nps " << nps;
+            printUciPV(std::span(line.pv.data(), line.pvLength));
+            std::cout << '\n';
+        }
+    }
+    else {
+        std::cout << "info depth " << reportedDepth << ' ';
+        printUciScore(result.score);
+        std::cout << " nodes " << totalNodes << " time " << elapsedMs << " nps " << nps;
+        printUciPV(std::span(result.pv.data(), result.pvLength));
+        std::cout << '\n';
+    }
     std::cout << "info string telemetry"
               << " nodes=" << result.telemetry.nodes
               << " qnodes=" << result.telemetry.qNodes
@@ -407,7 +581,14 @@ void Engine::printSearchResult_(const SearchLimits& limits, const SearchResult&
               << " tt_misses=" << result.telemetry.ttMisses
               << " tt_writes=" << result.telemetry.ttWrites
               << " tt_rewrites=" << result.telemetry.ttRewrites
-              << " completed_depth=" << result.telemetry.completedDepth << '\n';
+              << " eval_cache_hits=" << result.telemetry.evalCacheHits
+              << " eval_cache_misses=" << result.telemetry.evalCacheMisses
+              << " completed_depth=" << result.telemetry.completedDepth;
+    if (limits.treeStats)
+        std::cout << formatTreeStats(result.telemetry.treeStats);
+    std::cout << '\n';
+    if (!lastPerfCounters_.empty())
+        std::cout << "info string perf " << lastPerfCounters_ << '\n';
 
     for (const DistributedWorkerReport& report : lastDistributedReports_) {
         std::cout << "info string dist_worker"
@@ -435,7 +616,10 @@ void Engine::printSearchResult_(const SearchLimits& limits, const SearchResult&
                   << " bestmove=" << to_string(report.result.bestMove) << '\n';
     }
 
-    std::cout << "bestmove " << to_string(result.bestMove) << '\n';
+    std::cout << "bestmove " << to_string(result.bestMove);
+    if (result.pvLength >= 2)
+        std::cout << " ponder " << to_string(result.pv[1]);
+    std::cout << '\n';
     std::cout.flush();
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <condition_variable>
 #include <mutex>
 #include <span>
 #include <thread>
@@ -7,6 +8,8 @@
 #include "geometry.h"
 #include "move_gen/attacks.h"
 #include "distributed_search.h"
+#include "perf_counters.h"
+#include "perft.h"
 #include "position.h"
 #include "search.h"
 #include "types.h"
@@ -21,8 +24,6 @@ static std::once_flag initFlag;
 inline void init_engine() noexcept {
     std::call_once(initFlag, []() {
         zobrist::init_zobrist();
-        attacks::init_attack_tables();
-        geom::init_geometry_tables();
 
         static_assert(
             std::atomic<PackedTTEntry>::is_always_lock_free,
@@ -57,16 +58,22 @@ private:
     static constexpr int kDefaultHashMb = 256;
     static constexpr int kDefaultDepth = 8;
     static constexpr int kDefaultThreads = 1;
+    static constexpr int kMaxMultiPV = 256;
 
     std::vector<UCIOption> options_;
     std::vector<DistributedWorkerEndpoint> distributedWorkers_;
     std::vector<DistributedWorkerReport> lastDistributedReports_;
+    std::string lastPerfCounters_;  // Formatted counters of the last search, empty unless "Perf Counters" is on
+    std::string traceFile_;         // Chrome trace written after every search, tracing is off while empty
     DistributedCoordinatorSessions distributedCoordinatorSessions_{};
     Position position_{};
     std::vector<Key> positionHistory_;
     TranspositionTable tt_{static_cast<size_t>(kDefaultHashMb)};
     SearchLimits searchLimits_{kDefaultDepth, kDefaultThreads};
+    bool perfCounters_{false};
     SearchSharedState sharedSearchState_{};
+    std::mutex ponderMutex_;  // Guards clearing `sharedSearchState_.pondering` for `ponderCv_`
+    std::condition_variable ponderCv_;
     std::thread searchThread_;
 
     void setOption_(std::string name, std::string_view value);
@@ -79,10 +86,16 @@ private:
         std::optional<Depth> depthOverride,
         bool infinite,
         std::optional<std::chrono::milliseconds> moveTime,
-        std::optional<SearchLimits::TimeControl> timeControl
+        std::optional<SearchLimits::TimeControl> timeControl,
+        std::optional<uint64_t> nodes,
+        bool ponder,
+        std::vector<Move> searchMoves
     );
     void stopSearch_();
-    SearchResult runSearch_(const Position& root, const SearchLimits& limits);
+    void ponderHit_();
+    void writeTrace_() const;
+    void runPerft_(Depth depth);
+    SearchResult runSearch_(const Position& root, const SearchLimits& limits, std::span<const Move> rootMoves);
     static void mergeSearchResult_(SearchResult& aggregate, const SearchResult& workerResult, bool preferWorker);
     void printSearchResult_(const SearchLimits& limits, const SearchResult& result, uint64_t elapsedMs);
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "types.h"
+
+// A small direct-mapped cache of static evaluations (hash -> score), owned by a single search thread.
+// Unlike the transposition table, it is never shared, so entries and counters need no atomics.
+//
+// An entry is packed into 64 bits as follows:
+// Bits 0-15:       Score
+// Bits 16-63:      Upper 48 bits of the hash key
+//
+// The index covers the lowest log2(entries) key bits, so with fewer than 2^16 entries the key bits between the index
+// and bit 16 (only bit 15 by default) are never compared. A false hit still needs all 48 stored bits to match, which
+// happens with probability 2^-48 per probe, so those bits are not worth a wider entry.
+class EvalCache {
+public:
+    static constexpr size_t kDefaultEntries = size_t{1} << 15;  // 256 KiB per search thread
+
+    explicit EvalCache(size_t entries = kDefaultEntries)
+        : table_(std::bit_floor(std::max(entries, size_t{1}))), mask_(table_.size() - 1) {}
+
+    void clear() noexcept {
+        std::ranges::fill(table_, uint64_t{0});
+        resetCounters();
+    }
+
+    std::optional<Eval> probe(Key key) noexcept {
+        const uint64_t entry = table_[key & mask_];
+        if ((entry & kKeyMask) != (key & kKeyMask)) {
+            ++misses_;
+            return std::nullopt;
+        }
+
+        ++hits_;
+        return static_cast<Eval>(static_cast<int16_t>(entry & kScoreMask));
+    }
+
+    void store(Key key, Eval score) noexcept {
+        assert(score >= INT16_MIN && score <= INT16_MAX);
+        table_[key & mask_] = (key & kKeyMask) | static_cast<uint16_t>(static_cast<int16_t>(score));
+    }
+
+    // Statistics
+    uint64_t hits() const noexcept { return hits_; }
+    uint64_t misses() const noexcept { return misses_; }
+    void resetCounters() noexcept {
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+private:
+    static constexpr uint64_t kScoreMask = 0xFFFF;
+    static constexpr uint64_t kKeyMask = ~kScoreMask;
+
+    std::vector<uint64_t> table_;
+    size_t mask_{};
+    uint64_t hits_{};
+    uint64_t misses_{};
+};
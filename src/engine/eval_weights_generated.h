@@ -0,0 +1,103 @@
+// Auto generated by tools/tune_eval.cpp
+
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "types.h"
+
+inline constexpr std::array<int16_t, to_underlying(PieceType::Count)> kPieceValues = {
+    0,      // None
+    100,    // Pawn
+    300,    // Knight
+    330,    // Bishop
+    500,    // Rook
+    900,    // Queen
+    20000,  // King
+};
+
+inline constexpr std::array<int, to_underlying(PieceType::Count)> kMobilityWeights = {
+    0,  // None
+    0,  // Pawn
+    4,  // Knight
+    4,  // Bishop
+    2,  // Rook
+    1,  // Queen
+    0,  // King
+};
+
+// clang-format off
+inline constexpr std::array<int, 64> kPawnPST = {
+     +0,  +0,  +0,  +0,  +0,  +0,  +0,  +0,
+    +50, +50, +50, +50, +50, +50, +50, +50,
+    +10, +10, +20, +30, +30, +20, +10, +10,
+     +5,  +5, +10, +25, +25, +10,  +5,  +5,
+     +0,  +0,  +0, +20, +20,  +0,  +0,  +0,
+     +5,  -5, -10,  +0,  +0, -10,  -5,  +5,
+     +5, +10, +10, -20, -20, +10, +10,  +5,
+     +0,  +0,  +0,  +0,  +0,  +0,  +0,  +0,
+};
+
+inline constexpr std::array<int, 64> kKnightPST = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,  +0,  +0,  +0,  +0, -20, -40,
+    -30,  +0, +10, +15, +15, +10,  +0, -30,
+    -30,  +5, +15, +20, +20, +15,  +5, -30,
+    -30,  +0, +15, +20, +20, +15,  +0, -30,
+    -30,  +5, +10, +15, +15, +10,  +5, -30,
+    -40, -20,  +0,  +5,  +5,  +0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50,
+};
+
+inline constexpr std::array<int, 64> kBishopPST = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,  +0,  +0,  +0,  +0,  +0,  +0, -10,
+    -10,  +0,  +5, +10, +10,  +5,  +0, -10,
+    -10,  +5,  +5, +10, +10,  +5,  +5, -10,
+    -10,  +0, +10, +10, +10, +10,  +0, -10,
+    -10, +10, +10, +10, +10, +10, +10, -10,
+    -10,  +5,  +0,  +0,  +0,  +0,  +5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20,
+};
+
+inline constexpr std::array<int, 64> kRookPST = {
+     +0,  +0,  +0,  +5,  +5,  +0,  +0,  +0,
+     -5,  +0,  +0,  +0,  +0,  +0,  +0,  -5,
+     -5,  +0,  +0,  +0,  +0,  +0,  +0,  -5,
+     -5,  +0,  +0,  +0,  +0,  +0,  +0,  -5,
+     -5,  +0,  +0,  +0,  +0,  +0,  +0,  -5,
+     -5,  +0,  +0,  +0,  +0,  +0,  +0,  -5,
+     +5, +10, +10, +10, +10, +10, +10,  +5,
+     +0,  +0,  +0,  +0,  +0,  +0,  +0,  +0,
+};
+
+inline constexpr std::array<int, 64> kQueenPST = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,  +0,  +0,  +0,  +0,  +0,  +0, -10,
+    -10,  +0,  +5,  +5,  +5,  +5,  +0, -10,
+     -5,  +0,  +0,  +5,  +5,  +5,  +5,  -5,
+     +0,  +0,  +5,  +5,  +5,  +5,  +0,  -5,
+    -10,  +5,  +5,  +5,  +5,  +5,  +0, -10,
+    -10,  +0,  +5,  +0,  +0,  +0,  +0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+};
+
+inline constexpr std::array<int, 64> kKingPST = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+    +20, +20,  +0,  +0,  +0,  +0, +20, +20,
+    +20, +30, +10,  +0,  +0, +10, +30, +20,
+};
+// clang-format on
+
+inline constexpr int kBishopPairBonus = 30;
+
+// Threats: bonuses for attacking enemy pieces with lesser pieces, or enemy pieces that are undefended
+inline constexpr int kThreatByPawnBonus = 40;   // Per enemy non-pawn piece attacked by a pawn
+inline constexpr int kThreatByMinorBonus = 30;  // Per enemy rook or queen attacked by a knight or bishop
+inline constexpr int kThreatByRookBonus = 30;   // Per enemy queen attacked by a rook
+inline constexpr int kHangingPieceBonus = 20;   // Per enemy non-pawn piece attacked and not defended
@@ -1,99 +1,21 @@
 #pragma once
 
+#include "eval_weights_generated.h"
 #include "move_gen/attacks.h"
 #include "position.h"
 #include "types.h"
 #include "util.h"
 
-inline constexpr std::array<int16_t, to_underlying(PieceType::Count)> kPieceValues = {
-    0,      // None
-    100,    // Pawn
-    300,    // Knight
-    330,    // Bishop
-    500,    // Rook
-    900,    // Queen
-    20000,  // King
-};
-
-inline constexpr std::array<int, to_underlying(PieceType::Count)> kMobilityWeights = {
-    0,  // None
-    0,  // Pawn
-    4,  // Knight
-    4,  // Bishop
-    2,  // Rook
-    1,  // Queen
-    0,  // King
-};
-
-// clang-format off
-inline constexpr std::array<int, 64> kPawnPST = {
-    +0,   +0,   +0,  +0,  +0,  +0,  +0,  +0,
-    +50, +50,  +50, +50, +50, +50, +50, +50,
-    +10, +10,  +20, +30, +30, +20, +10, +10,
-    +5,   +5,  +10, +25, +25, +10,  +5,  +5,
-    +0,   +0,   +0, +20, +20,  +0,  +0,  +0,
-    +5,   -5,  -10,  +0,  +0, -10,  -5,  +5,
-    +5,  +10,  +10, -20, -20, +10, +10,  +5,
-    +0,   +0,   +0,  +0,  +0,  +0,  +0,  +0,
-};
-
-inline constexpr std::array<int, 64> kKnightPST = {
-    -50, -40,  -30, -30, -30, -30,  -40, -50,
-    -40, -20,   +0,  +0,  +0,  +0,  -20, -40,
-    -30,  +0,  +10, +15, +15, +10,   +0, -30,
-    -30,  +5,  +15, +20, +20, +15,   +5, -30,
-    -30,  +0,  +15, +20, +20, +15,   +0, -30,
-    -30,  +5,  +10, +15, +15, +10,   +5, -30,
-    -40, -20,   +0,  +5,  +5,  +0,  -20, -40,
-    -50, -40,  -30, -30, -30, -30,  -40, -50,
-};
-
-inline constexpr std::array<int, 64> kBishopPST = {
-    -20, -10, -10, -10, -10, -10, -10, -20,
-    -10,  +0,  +0,  +0,  +0,  +0,  +0, -10,
-    -10,  +0,  +5, +10, +10,  +5,  +0, -10,
-    -10,  +5,  +5, +10, +10,  +5,  +5, -10,
-    -10,  +0, +10, +10, +10, +10,  +0, -10,
-    -10, +10, +10, +10, +10, +10, +10, -10,
-    -10,  +5,  +0,  +0,  +0,  +0,  +5, -10,
-    -20, -10, -10, -10, -10, -10, -10, -20,
-};
-
-inline constexpr std::array<int, 64> kRookPST = {
-    +0,  +0,  +0,  +5,  +5,  +0,  +0, +0,
-    -5,  +0,  +0,  +0,  +0,  +0,  +0, -5,
-    -5,  +0,  +0,  +0,  +0,  +0,  +0, -5,
-    -5,  +0,  +0,  +0,  +0,  +0,  +0, -5,
-    -5,  +0,  +0,  +0,  +0,  +0,  +0, -5,
-    -5,  +0,  +0,  +0,  +0,  +0,  +0, -5,
-    +5, +10, +10, +10, +10, +10, +10, +5,
-    +0,  +0,  +0,  +0,  +0,  +0,  +0, +0,
-};
-
-inline constexpr std::array<int, 64> kQueenPST = {
-    -20, -10, -10,  -5,  -5, -10, -10, -20,
-    -10,  +0,  +0,  +0,  +0,  +0,  +0, -10,
-    -10,  +0,  +5,  +5,  +5,  +5,  +0, -10,
-    -5,   +0,  +0,  +5,  +5,  +5,  +5,  -5,
-    +0,   +0,  +5,  +5,  +5,  +5,  +0,  -5,
-    -10,  +5,  +5,  +5,  +5,  +5,  +0, -10,
-    -10,  +0,  +5,  +0,  +0,  +0,  +0, -10,
-    -20, -10, -10,  -5,  -5, -10, -10, -20,
-};
-
-inline constexpr std::array<int, 64> kKingPST = {
-    -30, -40, -40, -50, -50, -40, -40, -30,
-    -30, -40, -40, -50, -50, -40, -40, -30,
-    -30, -40, -40, -50, -50, -40, -40, -30,
-    -30, -40, -40, -50, -50, -40, -40, -30,
-    -20, -30, -30, -40, -40, -30, -30, -20,
-    -10, -20, -20, -20, -20, -20, -20, -10,
-    +20, +20,  +0,  +0,  +0,  +0, +20, +20,
-    +20, +30, +10,  +0,  +0, +10, +30, +20,
-};
-// clang-format on
+// The linear weights (material, piece-square tables, mobility, bishop pair, threats) are tuned by tools/tune_eval.cpp
+// and live in eval_weights_generated.h. King safety is non-linear and hand-set.
 
-inline constexpr int kBishopPairBonus = 30;
+// King safety: weight of each piece type attacking the enemy king zone, and of a safe check by that piece type
+inline constexpr std::array<int, to_underlying(PieceType::Count)> kKingAttackerWeights = {0, 0, 2, 2, 3, 5, 0};
+inline constexpr std::array<int, to_underlying(PieceType::Count)> kSafeCheckWeights = {0, 0, 6, 4, 6, 8, 0};
+inline constexpr int kKingZoneAttackWeight = 2;  // Per attacked king zone square (counted once per attacker)
+inline constexpr int kWeakKingZoneWeight = 3;    // Per king zone square attacked but only defended by the king
+inline constexpr int kKingDangerDivisor = 16;    // Penalty is danger^2 / divisor
+inline constexpr int kMaxKingDangerPenalty = 500;
 
 constexpr Square relative_square(Color c, Square sq) noexcept {
     return (c == Color::White) ? sq : static_cast<Square>(to_underlying(sq) ^ 56);
@@ -161,34 +83,187 @@ inline Eval bishop_pair_diff(const Position& pos) noexcept {
     return static_cast<Eval>(score);
 }
 
-inline Eval mobility_diff(const Position& pos) noexcept {
-    int score = 0;
-    const Bitboard occ = pos.occupancy();
+// Attack maps for both colors, computed once per evaluation and shared by all attack-based terms.
+struct AttackMaps {
+    // Squares attacked by each piece type of each color
+    std::array<std::array<Bitboard, to_underlying(PieceType::Count)>, to_underlying(Color::Count)> byPiece{};
+    std::array<Bitboard, to_underlying(Color::Count)> all{};    // Squares attacked by any piece of each color
+    std::array<Bitboard, to_underlying(Color::Count)> twice{};  // Squares attacked by at least two pieces of each color
+    // Number of squares attacked and not occupied by own pieces, for each piece type of each color
+    std::array<std::array<int, to_underlying(PieceType::Count)>, to_underlying(Color::Count)> mobility{};
 
-    for (const Color c : {Color::White, Color::Black}) {
-        const int sign = (c == Color::White) ? 1 : -1;
-        const Bitboard usOcc = pos.occupancy(c);
+    // King safety inputs, indexed by the attacking color
+    std::array<Bitboard, to_underlying(Color::Count)> enemyKingZone{};   // King zone of the opponent
+    std::array<int, to_underlying(Color::Count)> kingAttackers{};        // Pieces attacking the enemy king zone
+    std::array<int, to_underlying(Color::Count)> kingAttackersWeight{};  // Summed weights of those pieces
+    std::array<int, to_underlying(Color::Count)> kingZoneAttacks{};      // Attacked zone squares, per attacker
+};
 
-        for (const PieceType pt : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen}) {
-            Bitboard pieces = pos.get(c, pt);
-            while (pieces) {
-                const auto sq = static_cast<Square>(pop_lsb(pieces));
-                const Bitboard attacks = attacks::piece_attacks(pt, sq, occ) & ~usOcc;
-                score += sign * (bit_count(attacks) * kMobilityWeights[to_underlying(pt)]);
-            }
+// The king zone is the king's square and its neighbours, extended one rank towards the opponent.
+template <Color C>
+inline Bitboard king_zone(Square kingSq) noexcept {
+    const Bitboard zone = attacks::king_attacks(kingSq) | bitboard(kingSq);
+    return zone | ((C == Color::White) ? shift<Direction::North>(zone) : shift<Direction::South>(zone));
+}
+
+template <Color C, PieceType PT>
+inline void add_piece_attacks(const Position& pos, Bitboard occ, AttackMaps& maps) noexcept {
+    constexpr auto c = to_underlying(C);
+    const Bitboard usOcc = pos.occupancy(C);
+
+    Bitboard pieces = pos.get<C, PT>();
+    while (pieces) {
+        const auto sq = static_cast<Square>(pop_lsb(pieces));
+        const Bitboard attacks = attacks::piece_attacks<PT>(sq, occ);
+
+        maps.twice[c] |= maps.all[c] & attacks;
+        maps.all[c] |= attacks;
+        maps.byPiece[c][to_underlying(PT)] |= attacks;
+        maps.mobility[c][to_underlying(PT)] += bit_count(attacks & ~usOcc);
+
+        if (const Bitboard zoneAttacks = attacks & maps.enemyKingZone[c]) {
+            ++maps.kingAttackers[c];
+            maps.kingAttackersWeight[c] += kKingAttackerWeights[to_underlying(PT)];
+            maps.kingZoneAttacks[c] += bit_count(zoneAttacks);
         }
     }
+}
+
+template <Color C>
+inline void add_attacks(const Position& pos, AttackMaps& maps) noexcept {
+    constexpr auto c = to_underlying(C);
+    const Bitboard occ = pos.occupancy();
+
+    // Pawns and the king are handled set-wise, without iterating over individual pieces
+    const Bitboard pawns = pos.get<C, PieceType::Pawn>();
+    const Bitboard pawnAttacksEast = attacks::pawn_attacks_east<C>(pawns);
+    const Bitboard pawnAttacksWest = attacks::pawn_attacks_west<C>(pawns);
+    const Bitboard pawnAttacks = pawnAttacksEast | pawnAttacksWest;
+    const Bitboard kingAttacks = attacks::king_attacks(pos.kingSquare(C));
+
+    maps.byPiece[c][to_underlying(PieceType::Pawn)] = pawnAttacks;
+    maps.byPiece[c][to_underlying(PieceType::King)] = kingAttacks;
+    maps.all[c] = pawnAttacks | kingAttacks;
+    maps.twice[c] = (pawnAttacksEast & pawnAttacksWest) | (pawnAttacks & kingAttacks);
+
+    add_piece_attacks<C, PieceType::Knight>(pos, occ, maps);
+    add_piece_attacks<C, PieceType::Bishop>(pos, occ, maps);
+    add_piece_attacks<C, PieceType::Rook>(pos, occ, maps);
+    add_piece_attacks<C, PieceType::Queen>(pos, occ, maps);
+}
+
+inline AttackMaps compute_attack_maps(const Position& pos) noexcept {
+    AttackMaps maps{};
+    maps.enemyKingZone[to_underlying(Color::White)] = king_zone<Color::Black>(pos.kingSquare(Color::Black));
+    maps.enemyKingZone[to_underlying(Color::Black)] = king_zone<Color::White>(pos.kingSquare(Color::White));
+    add_attacks<Color::White>(pos, maps);
+    add_attacks<Color::Black>(pos, maps);
+    return maps;
+}
+
+inline Eval mobility_diff(const AttackMaps& maps) noexcept {
+    int score = 0;
+    for (const PieceType pt : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen}) {
+        const int count = maps.mobility[to_underlying(Color::White)][to_underlying(pt)] -
+                          maps.mobility[to_underlying(Color::Black)][to_underlying(pt)];
+        score += count * kMobilityWeights[to_underlying(pt)];
+    }
 
     return static_cast<Eval>(score);
 }
 
+// Returns the king danger penalty inflicted by the attacking color `Us` on the opponent's king.
+template <Color Us>
+inline int king_danger(const Position& pos, const AttackMaps& maps) noexcept {
+    constexpr Color Them = ~Us;
+    constexpr auto us = to_underlying(Us);
+    constexpr auto them = to_underlying(Them);
+
+    // A lone attacker (other than the queen) is rarely dangerous
+    const bool queenAttacks = (maps.byPiece[us][to_underlying(PieceType::Queen)] & maps.enemyKingZone[us]) != 0;
+    if (maps.kingAttackers[us] < 2 && !queenAttacks)
+        return 0;
+
+    const Square kingSq = pos.kingSquare(Them);
+    const Bitboard occ = pos.occupancy();
+    const Bitboard kingOnlyDefended = maps.byPiece[them][to_underlying(PieceType::King)] & ~maps.twice[them];
+    const Bitboard weakZone = maps.enemyKingZone[us] & maps.all[us] & (kingOnlyDefended | ~maps.all[them]);
+
+    // Checking squares that the defender does not cover and that are not blocked by our own pieces
+    const Bitboard safe = ~pos.occupancy(Us) & (~maps.all[them] | (weakZone & maps.twice[us]));
+    const Bitboard knightChecks = attacks::knight_attacks(kingSq) & safe;
+    const Bitboard bishopChecks = attacks::bishop_attacks(kingSq, occ) & safe;
+    const Bitboard rookChecks = attacks::rook_attacks(kingSq, occ) & safe;
+
+    int danger = maps.kingAttackersWeight[us];
+    danger += kKingZoneAttackWeight * maps.kingZoneAttacks[us];
+    danger += kWeakKingZoneWeight * bit_count(weakZone);
+    if (knightChecks & maps.byPiece[us][to_underlying(PieceType::Knight)])
+        danger += kSafeCheckWeights[to_underlying(PieceType::Knight)];
+    if (bishopChecks & maps.byPiece[us][to_underlying(PieceType::Bishop)])
+        danger += kSafeCheckWeights[to_underlying(PieceType::Bishop)];
+    if (rookChecks & maps.byPiece[us][to_underlying(PieceType::Rook)])
+        danger += kSafeCheckWeights[to_underlying(PieceType::Rook)];
+    if ((bishopChecks | rookChecks) & maps.byPiece[us][to_underlying(PieceType::Queen)])
+        danger += kSafeCheckWeights[to_underlying(PieceType::Queen)];
+
+    return std::min(danger * danger / kKingDangerDivisor, kMaxKingDangerPenalty);
+}
+
+inline Eval king_safety_diff(const Position& pos, const AttackMaps& maps) noexcept {
+    return static_cast<Eval>(king_danger<Color::White>(pos, maps) - king_danger<Color::Black>(pos, maps));
+}
+
+// Number of enemy pieces under each kind of threat, scored with the matching threat bonus.
+struct ThreatCounts {
+    int byPawn{};   // Non-pawn pieces attacked by a pawn
+    int byMinor{};  // Rooks and queens attacked by a knight or bishop
+    int byRook{};   // Queens attacked by a rook
+    int hanging{};  // Non-pawn pieces attacked and not defended
+};
+
+template <Color Us>
+inline ThreatCounts threat_counts(const Position& pos, const AttackMaps& maps) noexcept {
+    constexpr Color Them = ~Us;
+    constexpr auto us = to_underlying(Us);
+    constexpr auto them = to_underlying(Them);
+
+    const Bitboard minors = pos.get<Them, PieceType::Knight>() | pos.get<Them, PieceType::Bishop>();
+    const Bitboard majors = pos.get<Them, PieceType::Rook>() | pos.get<Them, PieceType::Queen>();
+    const Bitboard nonPawns = minors | majors;
+    const Bitboard byMinors =
+        maps.byPiece[us][to_underlying(PieceType::Knight)] | maps.byPiece[us][to_underlying(PieceType::Bishop)];
+
+    return ThreatCounts{
+        .byPawn = bit_count(nonPawns & maps.byPiece[us][to_underlying(PieceType::Pawn)]),
+        .byMinor = bit_count(majors & byMinors),
+        .byRook = bit_count(pos.get<Them, PieceType::Queen>() & maps.byPiece[us][to_underlying(PieceType::Rook)]),
+        .hanging = bit_count(nonPawns & maps.all[us] & ~maps.all[them]),
+    };
+}
+
+// Returns the threat bonus for the attacking color `Us` against the opponent's pieces.
+template <Color Us>
+inline int threats(const Position& pos, const AttackMaps& maps) noexcept {
+    const ThreatCounts counts = threat_counts<Us>(pos, maps);
+    return (kThreatByPawnBonus * counts.byPawn) + (kThreatByMinorBonus * counts.byMinor) +
+           (kThreatByRookBonus * counts.byRook) + (kHangingPieceBonus * counts.hanging);
+}
+
+inline Eval threats_diff(const Position& pos, const AttackMaps& maps) noexcept {
+    return static_cast<Eval>(threats<Color::White>(pos, maps) - threats<Color::Black>(pos, maps));
+}
+
 inline Eval evaluation(const Position& pos) noexcept {
     int score = 0;
+    const AttackMaps maps = compute_attack_maps(pos);
 
     score += material_diff(pos);
     score += piece_square_diff(pos);
     score += bishop_pair_diff(pos);
-    score += mobility_diff(pos);
+    score += mobility_diff(maps);
+    score += king_safety_diff(pos, maps);
+    score += threats_diff(pos, maps);
 
     return static_cast<Eval>(score);
 };
@@ -1,20 +1,29 @@
 #include "geometry.h"
 
-#include "move_gen/attacks.h"
+#include "move_gen/attacks_sliders.h"
 
 namespace geom {
 
-std::array<std::array<Bitboard, 64>, 64> line_table{};
-std::array<std::array<Bitboard, 64>, 64> between_table{};
-std::array<std::array<Bitboard, 64>, 64> ray_pass_table{};
+namespace {
+
+using SquarePairTable = std::array<std::array<Bitboard, 64>, 64>;
+
+struct GeometryTables {
+    SquarePairTable line{};
+    SquarePairTable between{};
+    SquarePairTable rayPass{};
+};
+
+// Builds the line, between, and ray_pass tables from the slider rays, without needing the attack tables.
+constexpr GeometryTables make_geometry_tables() noexcept {
+    GeometryTables tables{};
 
-void init_geometry_tables() noexcept {
     for (size_t i = 0; i < 64; ++i) {
         const auto from = static_cast<Square>(i);
         const Bitboard fromBB = bitboard(from);
 
-        const Bitboard orthogonalFrom = attacks::rook_attacks(from, 0);
-        const Bitboard diagonalFrom = attacks::bishop_attacks(from, 0);
+        const Bitboard orthogonalFrom = rook_attacks_ray(from, 0);
+        const Bitboard diagonalFrom = bishop_attacks_ray(from, 0);
 
         for (size_t j = 0; j < 64; ++j) {
             const auto to = static_cast<Square>(j);
@@ -24,25 +33,35 @@ void init_geometry_tables() noexcept {
             Bitboard between = 0;
             Bitboard rayPass = 0;
             if (orthogonalFrom & toBB) {
-                const Bitboard orthogonalTo = attacks::rook_attacks(to, 0);
+                const Bitboard orthogonalTo = rook_attacks_ray(to, 0);
 
                 line = (orthogonalFrom & orthogonalTo) | fromBB | toBB;
-                between = attacks::rook_attacks(from, toBB) & attacks::rook_attacks(to, fromBB);
-                rayPass = orthogonalFrom & (attacks::rook_attacks(to, fromBB) | toBB);
+                between = rook_attacks_ray(from, toBB) & rook_attacks_ray(to, fromBB);
+                rayPass = orthogonalFrom & (rook_attacks_ray(to, fromBB) | toBB);
             }
             else if (diagonalFrom & toBB) {
-                const Bitboard diagonalTo = attacks::bishop_attacks(to, 0);
+                const Bitboard diagonalTo = bishop_attacks_ray(to, 0);
 
                 line = (diagonalFrom & diagonalTo) | fromBB | toBB;
-                between = attacks::bishop_attacks(from, toBB) & attacks::bishop_attacks(to, fromBB);
-                rayPass = diagonalFrom & (attacks::bishop_attacks(to, fromBB) | toBB);
+                between = bishop_attacks_ray(from, toBB) & bishop_attacks_ray(to, fromBB);
+                rayPass = diagonalFrom & (bishop_attacks_ray(to, fromBB) | toBB);
             }
 
-            line_table[i][j] = line;
-            between_table[i][j] = between;
-            ray_pass_table[i][j] = rayPass;
+            tables.line[i][j] = line;
+            tables.between[i][j] = between;
+            tables.rayPass[i][j] = rayPass;
         }
     }
+
+    return tables;
 }
 
+constexpr GeometryTables kGeometryTables = make_geometry_tables();
+
+}  // namespace
+
+constinit const SquarePairTable line_table = kGeometryTables.line;
+constinit const SquarePairTable between_table = kGeometryTables.between;
+constinit const SquarePairTable ray_pass_table = kGeometryTables.rayPass;
+
 };  // namespace geom
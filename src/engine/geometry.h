@@ -71,12 +71,10 @@ constexpr Square step(Square sq, Direction dir) noexcept {
     return kStepTable[to_underlying(sq)][direction_index(dir)];
 }
 
-extern std::array<std::array<Bitboard, 64>, 64> line_table;
-extern std::array<std::array<Bitboard, 64>, 64> between_table;
-extern std::array<std::array<Bitboard, 64>, 64> ray_pass_table;
-
-// Initializes the line, between, and ray_pass tables.
-void init_geometry_tables() noexcept;
+// Generated at compile time in geometry.cpp
+extern const std::array<std::array<Bitboard, 64>, 64> line_table;
+extern const std::array<std::array<Bitboard, 64>, 64> between_table;
+extern const std::array<std::array<Bitboard, 64>, 64> ray_pass_table;
 
 // Returns bitboard of squares strictly between a and b (excluding a and b), or 0 if a and b are not aligned.
 inline Bitboard between(Square a, Square b) noexcept {
@@ -1,12 +1,30 @@
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <string_view>
 
+#include "bench.h"
 #include "distributed_search.h"
 #include "uciengine.h"
 
 int main(int argc, char* argv[]) {
     try {
+        // `bench [depth] [threads] [hash]` takes positional arguments, like the bench command of other engines
+        if (argc >= 2 && std::string_view(argv[1]) == "bench") {
+            engine::BenchOptions options;
+            if (argc >= 3)
+                options.depth = std::stoi(argv[2]);
+            if (argc >= 4)
+                options.threads = std::max(1, std::stoi(argv[3]));
+            if (argc >= 5)
+                options.hashMb = std::stoul(argv[4]);
+            if (argc >= 6)
+                throw std::invalid_argument("Unknown argument: " + std::string(argv[5]));
+
+            engine::run_bench(options, std::cout);
+            return EXIT_SUCCESS;
+        }
+
         std::string_view workerBindHost = "127.0.0.1";
         uint16_t workerPort = 0;
 
@@ -22,6 +40,7 @@ int main(int argc, char* argv[]) {
                 std::cout << "Usage:\n";
                 std::cout << "  engine\n";
                 std::cout << "  engine --worker-port <port> [--worker-bind <host>]\n";
+                std::cout << "  engine bench [depth] [threads] [hash]\n";
                 return EXIT_SUCCESS;
             }
             else {
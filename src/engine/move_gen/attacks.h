@@ -1,27 +1,22 @@
 #pragma once
+#include "../util.h"
 #include "attacks_leapers.h"
 #include "attacks_sliders.h"
 
 namespace attacks {
 
-// Initializes the attack tables for rooks and bishops. Must be called at startup.
-inline void init_attack_tables() noexcept {
-    init_rook_attacks_table();
-    init_bishop_attacks_table();
-}
-
 inline Bitboard rook_attacks(Square sq, Bitboard occ) noexcept {
     assert(is_valid(sq));
-    const Magic& magic = kRookMagics[to_underlying(sq)];
-    const size_t index = magic_index(magic, occ);
-    return kRookAttacksTable[(to_underlying(sq) * kRookStride) + index];
+    const Magic& magic = kRookTableMagics[to_underlying(sq)];
+    const size_t index = slider_index(magic, occ);
+    return kRookAttacksTable[magic.offset + index];
 }
 
 inline Bitboard bishop_attacks(Square sq, Bitboard occ) noexcept {
     assert(is_valid(sq));
-    const Magic& magic = kBishopMagics[to_underlying(sq)];
-    const size_t index = magic_index(magic, occ);
-    return kBishopAttacksTable[(to_underlying(sq) * kBishopStride) + index];
+    const Magic& magic = kBishopTableMagics[to_underlying(sq)];
+    const size_t index = slider_index(magic, occ);
+    return kBishopAttacksTable[magic.offset + index];
 }
 
 inline Bitboard queen_attacks(Square sq, Bitboard occ) noexcept {
@@ -44,6 +39,23 @@ inline Bitboard pawn_attacks(Color c, Square sq) noexcept {
     return kPawnAttacksTable[to_underlying(c)][to_underlying(sq)];
 }
 
+// Returns a bitboard of squares attacked towards the east/west by any pawn of the given color in the set.
+template <Color C>
+constexpr Bitboard pawn_attacks_east(Bitboard pawns) noexcept {
+    return (C == Color::White) ? shift<Direction::NorthEast>(pawns) : shift<Direction::SouthEast>(pawns);
+}
+
+template <Color C>
+constexpr Bitboard pawn_attacks_west(Bitboard pawns) noexcept {
+    return (C == Color::White) ? shift<Direction::NorthWest>(pawns) : shift<Direction::SouthWest>(pawns);
+}
+
+// Returns a bitboard of squares attacked by any pawn of the given color in the set.
+template <Color C>
+constexpr Bitboard pawn_attacks(Bitboard pawns) noexcept {
+    return pawn_attacks_east<C>(pawns) | pawn_attacks_west<C>(pawns);
+}
+
 // Returns a bitboard of squares attacked by a piece of the given type for the square and (optional) occupancy.
 template <PieceType PT>
     requires(PT == PieceType::Knight || PT == PieceType::Bishop || PT == PieceType::Rook || PT == PieceType::Queen)
@@ -0,0 +1,6 @@
+#include "attacks_sliders.h"
+
+// Evaluated once here rather than in every translation unit including the header. `constinit` guarantees no
+// runtime initialization, so the tables are emitted as read-only data.
+constinit const std::array<Bitboard, kRookAttacksTableSize> kRookAttacksTable = make_rook_attacks_table();
+constinit const std::array<Bitboard, kBishopAttacksTableSize> kBishopAttacksTable = make_bishop_attacks_table();
@@ -3,18 +3,93 @@
 
 #pragma once
 #include <array>
+#include <bit>
 
 #include "magics_generated.h"
 
-const size_t kRookStride = 4096;
-const size_t kBishopStride = 512;
-inline std::array<Bitboard, 64 * kRookStride> kRookAttacksTable;
-inline std::array<Bitboard, 64 * kBishopStride> kBishopAttacksTable;
+#if defined(USE_PEXT)
+#include <immintrin.h>
+#endif
 
 constexpr size_t magic_index(const Magic& magic, Bitboard blockers) noexcept {
     return static_cast<size_t>(((blockers & magic.mask) * magic.magic) >> magic.shift);
 }
 
+// Checks that every square's entries start where the previous square's end and that they fill the table exactly.
+constexpr bool is_packed_layout(const std::array<Magic, 64>& magics, size_t tableSize) noexcept {
+    size_t offset = 0;
+    for (const Magic& magic : magics) {
+        if (magic.offset != offset)
+            return false;
+        offset += size_t{1} << (64 - magic.shift);
+    }
+    return offset == tableSize;
+}
+static_assert(is_packed_layout(kRookMagics, kRookTableSize), "Rook magics do not match the packed table layout");
+static_assert(is_packed_layout(kBishopMagics, kBishopTableSize), "Bishop magics do not match the packed table layout");
+
+// `kRookTableMagics` and `kBishopTableMagics` describe the attack table layout used by the build's backend.
+#if defined(USE_PEXT)
+// PEXT indices span every relevant bit of the mask, so they need their own packed layout: magics found with fewer
+// index bits (see `find_magics --shrink`) would otherwise overflow into the next square's entries.
+constexpr std::array<Magic, 64> pext_layout(std::array<Magic, 64> magics) noexcept {
+    uint32_t offset = 0;
+    for (Magic& magic : magics) {
+        magic.shift = static_cast<uint8_t>(64 - std::popcount(magic.mask));
+        magic.offset = offset;
+        offset += uint32_t{1} << std::popcount(magic.mask);
+    }
+    return magics;
+}
+
+inline constexpr std::array<Magic, 64> kRookTableMagics = pext_layout(kRookMagics);
+inline constexpr std::array<Magic, 64> kBishopTableMagics = pext_layout(kBishopMagics);
+#else
+inline constexpr const std::array<Magic, 64>& kRookTableMagics = kRookMagics;
+inline constexpr const std::array<Magic, 64>& kBishopTableMagics = kBishopMagics;
+#endif
+
+// Returns the number of entries of a packed table, which ends with the last square's entries.
+constexpr size_t packed_table_size(const std::array<Magic, 64>& magics) noexcept {
+    return magics[63].offset + (size_t{1} << (64 - magics[63].shift));
+}
+
+inline constexpr size_t kRookAttacksTableSize = packed_table_size(kRookTableMagics);
+inline constexpr size_t kBishopAttacksTableSize = packed_table_size(kBishopTableMagics);
+
+// Each square's attacks are packed back to back at its magic's `offset` ("fancy" magics), so the tables only take
+// `1 << indexBits` entries per square (~800 KB for rooks) instead of the maximum for every square.
+// Generated at compile time in attacks_sliders.cpp, so they live in read-only data shared across processes.
+extern const std::array<Bitboard, kRookAttacksTableSize> kRookAttacksTable;
+extern const std::array<Bitboard, kBishopAttacksTableSize> kBishopAttacksTable;
+
+// Portable equivalent of PEXT: gathers the bits of `b` selected by `mask` into the low bits, in mask order.
+constexpr size_t pext_index(Bitboard b, Bitboard mask) noexcept {
+    size_t index = 0;
+    for (size_t bit = 1; mask; bit <<= 1) {
+        const Bitboard lsb = mask & (~mask + 1);
+        mask ^= lsb;
+        if (b & lsb)
+            index |= bit;
+    }
+    return index;
+}
+
+// Returns the attack table index of the blockers for the build's backend. With `USE_PEXT` the relevant blocker bits are
+// gathered directly by BMI2 PEXT, giving a dense index below `1 << relevantBits` without the magic multiply.
+constexpr size_t slider_index(const Magic& magic, Bitboard blockers) noexcept {
+#if defined(USE_PEXT)
+    if consteval {
+        return pext_index(blockers, magic.mask);
+    }
+    else {
+        return static_cast<size_t>(_pext_u64(blockers, magic.mask));
+    }
+#else
+    return magic_index(magic, blockers);
+#endif
+}
+
 constexpr Bitboard rook_mask(Square sq) noexcept {
     Bitboard mask = 0;
     const int curFile = to_underlying(file(sq));
@@ -148,33 +223,37 @@ constexpr Bitboard index_to_occupancy(Bitboard magic_mask, size_t magic_index) n
     return occ;
 }
 
-// Initializes the rook and bishop attack tables by iterating over all squares and all blocker configurations
-// Must occur at startup before move generation is used
+// Build the rook and bishop attack tables by iterating over all squares and all blocker configurations
+// Only meant for constant evaluation, see attacks_sliders.cpp
 
-constexpr void init_rook_attacks_table() noexcept {
+constexpr std::array<Bitboard, kRookAttacksTableSize> make_rook_attacks_table() noexcept {
+    std::array<Bitboard, kRookAttacksTableSize> table{};
     for (size_t i = 0; i < 64; ++i) {
         const auto sq = static_cast<Square>(i);
-        const Magic magic = kRookMagics[i];
-        const size_t relevantBlockerCount = 1ULL << (64 - magic.shift);
+        const Magic magic = kRookTableMagics[i];
 
-        for (size_t j = 0; j < relevantBlockerCount; ++j) {
-            const Bitboard blockers = index_to_occupancy(magic.mask, j);
-            const size_t idx = magic_index(magic, blockers);
-            kRookAttacksTable[(i * kRookStride) + idx] = rook_attacks_ray(sq, blockers);
-        }
+        // Enumerate every subset of the mask with the Carry-Rippler trick, ending back at the empty set
+        Bitboard blockers = 0;
+        do {
+            table[magic.offset + slider_index(magic, blockers)] = rook_attacks_ray(sq, blockers);
+            blockers = (blockers - magic.mask) & magic.mask;
+        } while (blockers != 0);
     }
+    return table;
 }
 
-constexpr void init_bishop_attacks_table() noexcept {
+constexpr std::array<Bitboard, kBishopAttacksTableSize> make_bishop_attacks_table() noexcept {
+    std::array<Bitboard, kBishopAttacksTableSize> table{};
     for (size_t i = 0; i < 64; ++i) {
         const auto sq = static_cast<Square>(i);
-        const Magic magic = kBishopMagics[i];
-        const size_t relevantBlockerCount = 1ULL << (64 - magic.shift);
+        const Magic magic = kBishopTableMagics[i];
 
-        for (size_t j = 0; j < relevantBlockerCount; ++j) {
-            const Bitboard blockers = index_to_occupancy(magic.mask, j);
-            const size_t idx = magic_index(magic, blockers);
-            kBishopAttacksTable[(i * kBishopStride) + idx] = bishop_attacks_ray(sq, blockers);
-        }
+        // Enumerate every subset of the mask with the Carry-Rippler trick, ending back at the empty set
+        Bitboard blockers = 0;
+        do {
+            table[magic.offset + slider_index(magic, blockers)] = bishop_attacks_ray(sq, blockers);
+            blockers = (blockers - magic.mask) & magic.mask;
+        } while (blockers != 0);
     }
+    return table;
 }
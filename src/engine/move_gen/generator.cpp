@@ -3,7 +3,30 @@
 namespace {
 
 constexpr bool includes_quiets(GenMode mode) noexcept {
-    return mode == GenMode::Legal || mode == GenMode::Evasions;
+    return mode != GenMode::Tactical;
+}
+
+constexpr bool includes_tactical(GenMode mode) noexcept {
+    return mode == GenMode::Legal || mode == GenMode::Tactical || mode == GenMode::Evasions;
+}
+
+// Returns the pieces of `blockerColor` that are the only piece between `kingSq` and a slider of `sliderColor`.
+Bitboard slider_blockers(const Position& pos, Square kingSq, Color sliderColor, Color blockerColor) noexcept {
+    // X-ray the king's slider attacks through the blocker color's pieces: sliders seen this way are candidates
+    const Bitboard xrayOcc = pos.occupancy() & ~pos.occupancy(blockerColor);
+    const Bitboard queens = pos.get(sliderColor, PieceType::Queen);
+    Bitboard snipers = (attacks::rook_attacks(kingSq, xrayOcc) & (pos.get(sliderColor, PieceType::Rook) | queens)) |
+                       (attacks::bishop_attacks(kingSq, xrayOcc) & (pos.get(sliderColor, PieceType::Bishop) | queens));
+
+    Bitboard blockers = 0;
+    while (snipers) {
+        const auto sniperSq = static_cast<Square>(pop_lsb(snipers));
+        // Any piece in between belongs to the blocker color, as all others stop the x-ray
+        const Bitboard between = geom::between(kingSq, sniperSq) & pos.occupancy();
+        if (between && !more_than_one(between))
+            blockers |= between;
+    }
+    return blockers;
 }
 
 // Generates the evasion mask for a king in check by a single piece.
@@ -20,82 +43,80 @@ Bitboard evasion_mask(const Position& pos, Square kingSq, Bitboard checkers) noe
     return mask;
 }
 
-struct PinsInfo {
-    std::array<Bitboard, 64> pinRay{};  // Allowed destinations if pinned; ~0 if not pinned
-    Bitboard pinned = 0;
-};
-
-// Computes pinned pieces and their corresponding pin rays for the given position and side to move.
-PinsInfo compute_pins(const Position& pos, Color us) noexcept {
-    PinsInfo pins;
-    pins.pinRay.fill(~Bitboard{0});
-
-    const Square kingSq = pos.kingSquare(us);
-
-    auto scan_direction = [&](Direction dir) noexcept {
-        Square candidate = Square::None;
-        for (Square sq = geom::step(kingSq, dir); is_valid(sq); sq = geom::step(sq, dir)) {
-            const Piece p = pos.pieceOn(sq);
-            if (is_empty(p))
-                continue;
-
-            // Check if the piece is a friendly piece blocking the pin
-            if (color(p) == us) {
-                if (!is_valid(candidate)) {
-                    candidate = sq;
-                    continue;
-                }
-                return;
-            }
-            // If enemy piece found that slides in this direction, it's a pin
-            if (is_valid(candidate) && is_slider_for_direction(piece_type(p), dir)) {
-                pins.pinned |= bitboard(candidate);
-                // Build ray from king to pinner
-                pins.pinRay[to_underlying(candidate)] = geom::between_or_to(kingSq, sq);
-            }
-            return;
-        }
-    };
-
-    for (const Direction dir : geom::kDirections) {
-        scan_direction(dir);
-    }
-
-    return pins;
-}
-
 // Holds state relevant to move generation, to avoid redundant accesses/computations during move generation.
 struct State {
-    PinsInfo pins{};
     Bitboard occ{}, usOcc{}, themOcc{};
     Bitboard checkers{};
+    Bitboard pinned{};
     Bitboard evasionMask{};
-    Color us{}, them{};
+    Bitboard discoverers{};  // Our pieces whose move can uncover a check (only for `QuietChecks`)
     Square kingSq{};
+    Square theirKingSq{};
     uint8_t numCheckers{};
 };
 
+template <Color Us, GenMode Mode, bool Pseudo>
 State init_state(const Position& pos) noexcept {
     State state{};
 
-    state.us = pos.sideToMove();
-    state.them = ~state.us;
-    state.kingSq = pos.kingSquare(state.us);
+    state.kingSq = pos.kingSquare(Us);
     state.occ = pos.occupancy();
-    state.usOcc = pos.occupancy(state.us);
-    state.themOcc = pos.occupancy(state.them);
-    state.checkers = checkers(pos, state.us);
+    state.usOcc = pos.occupancy(Us);
+    state.themOcc = pos.occupancy(~Us);
+    state.checkers = pos.checkers();
     state.numCheckers = bit_count(state.checkers);
-    state.pins = compute_pins(pos, state.us);
+    // Pseudo-legal moves ignore pins, leaving them to `Position::isLegal`
+    state.pinned = Pseudo ? Bitboard{0} : pos.pinned();
     state.evasionMask = (state.numCheckers == 1) ? evasion_mask(pos, state.kingSq, state.checkers) : ~Bitboard{0};
+    state.theirKingSq = pos.kingSquare(~Us);
+    if constexpr (Mode == GenMode::QuietChecks)
+        state.discoverers = slider_blockers(pos, state.theirKingSq, Us, Us);
 
     return state;
 }
 
-void generate_king_moves(const Position& pos, const State& state, MoveList& moveList, GenMode mode) noexcept {
-    Bitboard targets = attacks::king_attacks(state.kingSq) & ~state.usOcc;
-    if (mode == GenMode::Tactical)
-        targets &= state.themOcc;
+// Returns the destination squares a mode may move to, before pins, evasions and checks are applied.
+template <GenMode Mode>
+Bitboard mode_targets(const State& state) noexcept {
+    if constexpr (Mode == GenMode::Tactical)
+        return state.themOcc;
+    else if constexpr (includes_tactical(Mode))
+        return ~state.usOcc;
+    else
+        return ~state.occ;
+}
+
+// Returns the destinations from which a quiet move of a piece on `from` gives check: the piece's check squares,
+// plus every square off the line to the enemy king if the piece uncovers a slider.
+Bitboard check_filter(const Position& pos, const State& state, Square from, PieceType pt) noexcept {
+    Bitboard filter = pos.checkSquares(pt);
+    if (state.discoverers & bitboard(from))
+        filter |= ~geom::line(state.theirKingSq, from);
+    return filter;
+}
+
+// Returns the destinations allowed for a piece on `from` by its pin: the line through the king if pinned, else all.
+Bitboard pin_filter(const State& state, Square from) noexcept {
+    return (state.pinned & bitboard(from)) ? geom::line(state.kingSq, from) : ~Bitboard{0};
+}
+
+void push_simple_moves(Square from, Bitboard targets, Bitboard themOcc, MoveList& moveList) noexcept {
+    while (targets) {
+        const auto to = static_cast<Square>(pop_lsb(targets));
+        const MoveType moveType = (themOcc & bitboard(to)) ? MoveType::Capture : MoveType::Normal;
+        moveList.push_back(Move(from, to, moveType));
+    }
+}
+
+template <Color Us, GenMode Mode, bool Pseudo>
+void generate_king_moves(const Position& pos, const State& state, MoveList& moveList) noexcept {
+    Bitboard targets = attacks::king_attacks(state.kingSq) & mode_targets<Mode>(state);
+    if constexpr (Mode == GenMode::QuietChecks)
+        targets &= check_filter(pos, state, state.kingSq, PieceType::King);
+    if constexpr (Pseudo) {
+        push_simple_moves(state.kingSq, targets, state.themOcc, moveList);
+        return;
+    }
     while (targets) {
         const auto to = static_cast<Square>(pop_lsb(targets));
         // Build occupancy after king moves (remove king, capture if enemy present, place king)
@@ -105,31 +126,27 @@ void generate_king_moves(const Position& pos, const State& state, MoveList& move
             afterKingMoveOcc ^= bitboard(to);
         afterKingMoveOcc |= bitboard(to);
         // Ensure king doesn't move into check
-        if (!is_square_attacked(pos, to, state.them, afterKingMoveOcc)) {
+        if (!is_square_attacked(pos, to, ~Us, afterKingMoveOcc)) {
             const MoveType moveType = (state.themOcc & bitboard(to)) ? MoveType::Capture : MoveType::Normal;
             moveList.push_back(Move(state.kingSq, to, moveType));
         }
     }
 }
 
-void push_simple_moves(Square from, Bitboard targets, Bitboard themOcc, MoveList& moveList) noexcept {
-    while (targets) {
-        const auto to = static_cast<Square>(pop_lsb(targets));
-        const MoveType moveType = (themOcc & bitboard(to)) ? MoveType::Capture : MoveType::Normal;
-        moveList.push_back(Move(from, to, moveType));
-    }
-}
+template <Color Us, PieceType PT, GenMode Mode>
+void generate_piece_moves(const Position& pos, const State& state, MoveList& moveList) noexcept {
+    Bitboard pieces = pos.get<Us, PT>();
+    // A pinned knight can never stay on its pin line
+    if constexpr (PT == PieceType::Knight)
+        pieces &= ~state.pinned;
 
-template <PieceType PT>
-void generate_piece_moves(const Position& pos, const State& state, MoveList& moveList, GenMode mode) {
-    Bitboard pieces = pos.get(state.us, PT);
     while (pieces) {
         const auto from = static_cast<Square>(pop_lsb(pieces));
-        Bitboard targets = attacks::piece_attacks<PT>(from, state.occ) & ~state.usOcc;
+        Bitboard targets = attacks::piece_attacks<PT>(from, state.occ) & mode_targets<Mode>(state);
 
-        targets &= state.pins.pinRay[to_underlying(from)] & state.evasionMask;
-        if (mode == GenMode::Tactical)
-            targets &= state.themOcc;
+        targets &= pin_filter(state, from) & state.evasionMask;
+        if constexpr (Mode == GenMode::QuietChecks)
+            targets &= check_filter(pos, state, from, PT);
 
         push_simple_moves(from, targets, state.themOcc, moveList);
     }
@@ -150,160 +167,207 @@ void push_promotions(Square from, Square to, bool isCapture, MoveList& moveList)
     }
 }
 
-void push_pawn_attacks(
-    Square from,
-    Bitboard targets,
-    Bitboard themOcc,
-    Color us,
-    MoveType baseMoveType,
-    MoveList& moveList
-) noexcept {
-    const Bitboard promotionMask = us == Color::White ? bitboard(Rank::R8) : bitboard(Rank::R1);
-    Bitboard promoTargets = targets & promotionMask;
-    Bitboard nonPromoTargets = targets & ~promotionMask;
-
-    while (promoTargets) {
-        const auto to = static_cast<Square>(pop_lsb(promoTargets));
-        const bool isCapture = (themOcc & bitboard(to)) != 0;
-        push_promotions(from, to, isCapture, moveList);
+// Appends a move to every target square, from the square `Offset` behind it.
+template <Direction Offset>
+void push_pawn_moves(Bitboard targets, MoveType moveType, MoveList& moveList) noexcept {
+    while (targets) {
+        const auto to = static_cast<Square>(pop_lsb(targets));
+        moveList.push_back(Move(to - Offset, to, moveType));
     }
-    while (nonPromoTargets) {
-        const auto to = static_cast<Square>(pop_lsb(nonPromoTargets));
-        const MoveType moveType = (themOcc & bitboard(to)) ? MoveType::Capture : baseMoveType;
-        moveList.push_back(Move(from, to, moveType));
+}
+
+template <Direction Offset>
+void push_pawn_promotions(Bitboard targets, bool isCapture, MoveList& moveList) noexcept {
+    while (targets) {
+        const auto to = static_cast<Square>(pop_lsb(targets));
+        push_promotions(to - Offset, to, isCapture, moveList);
     }
 }
 
-void generate_pawn_moves(const Position& pos, const State& state, MoveList& moveList, GenMode mode) noexcept {
-    const Bitboard pawns = pos.get(state.us, PieceType::Pawn);
-    const Bitboard promotionMask = (state.us == Color::White) ? bitboard(Rank::R8) : bitboard(Rank::R1);
-    // Captures
-    {
-        Bitboard p = pawns;
-        while (p) {
-            const auto from = static_cast<Square>(pop_lsb(p));
-            Bitboard targets = attacks::pawn_attacks(state.us, from) & state.themOcc;
-            targets &= state.pins.pinRay[to_underlying(from)] & state.evasionMask;
-            push_pawn_attacks(from, targets, state.themOcc, state.us, MoveType::Normal, moveList);
-        }
+// Generates the moves of a set of pawns whose destinations are all restricted by the same `filter`.
+template <Color Us, GenMode Mode>
+void generate_pawn_set_moves(Bitboard pawns, Bitboard filter, const State& state, MoveList& moveList) noexcept {
+    constexpr bool white = Us == Color::White;
+    constexpr Direction Up = white ? Direction::North : Direction::South;
+    constexpr Direction UpEast = white ? Direction::NorthEast : Direction::SouthEast;
+    constexpr Direction UpWest = white ? Direction::NorthWest : Direction::SouthWest;
+    constexpr auto DoubleUp = static_cast<Direction>(2 * to_underlying(Up));
+    constexpr Bitboard promotionRank = bitboard(white ? Rank::R8 : Rank::R1);
+    constexpr Bitboard doublePushRank = bitboard(white ? Rank::R3 : Rank::R6);  // Rank reached by the first step
+
+    // Pushes (non-capturing promotions are tactical, other pushes are quiet)
+    const Bitboard singlePushes = shift<Up>(pawns) & ~state.occ;
+    if constexpr (includes_tactical(Mode))
+        push_pawn_promotions<Up>(singlePushes & promotionRank & filter, false, moveList);
+    if constexpr (includes_quiets(Mode)) {
+        const Bitboard doublePushes = shift<Up>(singlePushes & doublePushRank) & ~state.occ;
+        push_pawn_moves<Up>(singlePushes & ~promotionRank & filter, MoveType::Normal, moveList);
+        push_pawn_moves<DoubleUp>(doublePushes & filter, MoveType::PawnDoubleStep, moveList);
     }
-    // Pushes
-    if (includes_quiets(mode)) {
-        Bitboard p = pawns;
-        while (p) {
-            // Single push
-            const auto from = static_cast<Square>(pop_lsb(p));
-            const Bitboard filter = state.pins.pinRay[to_underlying(from)] & state.evasionMask;
-            const Direction dir = (state.us == Color::White) ? Direction::North : Direction::South;
-            const Square singlePushTo = geom::step(from, dir);
-            if (!is_valid(singlePushTo) || (state.occ & bitboard(singlePushTo)) != 0)
-                continue;
 
-            const Bitboard singleTargets = bitboard(singlePushTo) & filter;
-            push_pawn_attacks(from, singleTargets, state.themOcc, state.us, MoveType::Normal, moveList);
+    // Captures
+    if constexpr (includes_tactical(Mode)) {
+        const Bitboard eastCaptures = shift<UpEast>(pawns) & state.themOcc & filter;
+        const Bitboard westCaptures = shift<UpWest>(pawns) & state.themOcc & filter;
+        push_pawn_promotions<UpEast>(eastCaptures & promotionRank, true, moveList);
+        push_pawn_promotions<UpWest>(westCaptures & promotionRank, true, moveList);
+        push_pawn_moves<UpEast>(eastCaptures & ~promotionRank, MoveType::Capture, moveList);
+        push_pawn_moves<UpWest>(westCaptures & ~promotionRank, MoveType::Capture, moveList);
+    }
+}
 
-            // Double push (if on starting rank and single push was also valid)
-            const Rank startRank = (state.us == Color::White) ? Rank::R2 : Rank::R7;
-            if (rank(from) != startRank)
-                continue;
+template <Color Us, GenMode Mode>
+void generate_pawn_moves(const Position& pos, const State& state, MoveList& moveList) noexcept {
+    const Bitboard pawns = pos.get<Us, PieceType::Pawn>();
 
-            const Square doublePushTo = geom::step(singlePushTo, dir);
-            if (!is_valid(doublePushTo) || (state.occ & bitboard(doublePushTo)) != 0)
-                continue;
-            const Bitboard doubleTargets = bitboard(doublePushTo) & filter;
-            push_pawn_attacks(from, doubleTargets, state.themOcc, state.us, MoveType::PawnDoubleStep, moveList);
-        }
+    // Pinned pawns (and, for quiet checks, pawns uncovering a check) are rare; generate each one separately
+    Bitboard special = pawns & state.pinned;
+    Bitboard filter = state.evasionMask;
+    if constexpr (Mode == GenMode::QuietChecks) {
+        special |= pawns & state.discoverers;
+        filter &= pos.checkSquares(PieceType::Pawn);
     }
-    // Non-capturing promotions
-    else {
-        Bitboard p = pawns;
-        while (p) {
-            const auto from = static_cast<Square>(pop_lsb(p));
-            const Bitboard filter = state.pins.pinRay[to_underlying(from)] & state.evasionMask;
-            const Direction dir = (state.us == Color::White) ? Direction::North : Direction::South;
-            const Square singlePushTo = geom::step(from, dir);
-            if (!is_valid(singlePushTo) || (state.occ & bitboard(singlePushTo)) != 0)
-                continue;
 
-            const Bitboard promoTargets = bitboard(singlePushTo) & filter & promotionMask;
-            push_pawn_attacks(from, promoTargets, state.themOcc, state.us, MoveType::Normal, moveList);
-        }
+    generate_pawn_set_moves<Us, Mode>(pawns & ~special, filter, state, moveList);
+
+    while (special) {
+        const auto from = static_cast<Square>(pop_lsb(special));
+        Bitboard pawnFilter = pin_filter(state, from) & state.evasionMask;
+        if constexpr (Mode == GenMode::QuietChecks)
+            pawnFilter &= check_filter(pos, state, from, PieceType::Pawn);
+        generate_pawn_set_moves<Us, Mode>(bitboard(from), pawnFilter, state, moveList);
     }
 }
 
-void generate_castling_moves(const Position& pos, const State& state, MoveList& moveList, GenMode mode) noexcept {
-    if (mode != GenMode::Legal || state.numCheckers > 0)
-        return;
+// Checks if castling, given the king and rook squares, leaves the enemy king attacked by one of our sliders.
+template <Color Us>
+bool castling_gives_check(
+    const Position& pos,
+    const State& state,
+    Square kingFrom,
+    Square kingTo,
+    Square rookFrom,
+    Square rookTo
+) noexcept {
+    const Bitboard occAfter = (state.occ ^ bitboard(kingFrom) ^ bitboard(rookFrom)) | bitboard(kingTo) | bitboard(rookTo);
+    const Bitboard queens = pos.get<Us, PieceType::Queen>();
+    const Bitboard rooks = (pos.get<Us, PieceType::Rook>() ^ bitboard(rookFrom)) | bitboard(rookTo);
+    return (attacks::rook_attacks(state.theirKingSq, occAfter) & (rooks | queens)) ||
+           (attacks::bishop_attacks(state.theirKingSq, occAfter) & (pos.get<Us, PieceType::Bishop>() | queens));
+}
 
-    const CastlingRights mask = (state.us == Color::White)
-                                    ? (CastlingRights::WhiteKingside | CastlingRights::WhiteQueenside)
-                                    : (CastlingRights::BlackKingside | CastlingRights::BlackQueenside);
-    const CastlingRights cr = pos.castlingRights() & mask;
-    if (cr == CastlingRights::None)
-        return;
+template <Color Us, GenMode Mode>
+void generate_castling_moves(const Position& pos, const State& state, MoveList& moveList) noexcept {
+    if constexpr (Mode == GenMode::Legal || Mode == GenMode::Quiets || Mode == GenMode::QuietChecks) {
+        constexpr bool white = Us == Color::White;
+        constexpr CastlingRights kingside = white ? CastlingRights::WhiteKingside : CastlingRights::BlackKingside;
+        constexpr CastlingRights queenside = white ? CastlingRights::WhiteQueenside : CastlingRights::BlackQueenside;
+        constexpr Square kingFrom = white ? Square::E1 : Square::E8;
+        constexpr Square kingsideTo = white ? Square::G1 : Square::G8;
+        constexpr Square queensideTo = white ? Square::C1 : Square::C8;
+        constexpr Square queensideRookPath = white ? Square::B1 : Square::B8;
+        constexpr Square kingsideRookFrom = white ? Square::H1 : Square::H8;
+        constexpr Square kingsideRookTo = white ? Square::F1 : Square::F8;
+        constexpr Square queensideRookFrom = white ? Square::A1 : Square::A8;
+        constexpr Square queensideRookTo = white ? Square::D1 : Square::D8;
+
+        const CastlingRights cr = pos.castlingRights();
+        if (state.numCheckers > 0 || (cr & (kingside | queenside)) == CastlingRights::None)
+            return;
 
-    if (state.us == Color::White) {
-        if (has_right(cr, CastlingRights::WhiteKingside)) {
-            const Square from = Square::E1;
-            const Square to = Square::G1;
-            const Bitboard fullPath = geom::between_or_to(from, to);
-            if ((state.occ & fullPath) == 0 && !is_any_square_attacked(pos, fullPath, state.them)) {
-                moveList.push_back(Move(from, to, MoveType::CastleKing));
+        if (has_right(cr, kingside)) {
+            const Bitboard fullPath = geom::between_or_to(kingFrom, kingsideTo);
+            const bool allowed = Mode != GenMode::QuietChecks ||
+                                 castling_gives_check<Us>(pos, state, kingFrom, kingsideTo, kingsideRookFrom, kingsideRookTo);
+            if (allowed && (state.occ & fullPath) == 0 && !is_any_square_attacked(pos, fullPath, ~Us)) {
+                moveList.push_back(Move(kingFrom, kingsideTo, MoveType::CastleKing));
             }
         }
-        if (has_right(cr, CastlingRights::WhiteQueenside)) {
-            const Square from = Square::E1;
-            const Square to = Square::C1;
+        if (has_right(cr, queenside)) {
             // Ensure the full path is clear, and that the king's path isn't attacked
-            const Bitboard kingPath = geom::between_or_to(from, to);
-            const Bitboard fullPath = geom::between_or_to(from, Square::B1);
-            if ((state.occ & fullPath) == 0 && !is_any_square_attacked(pos, kingPath, state.them)) {
-                moveList.push_back(Move(from, to, MoveType::CastleQueen));
-            }
-        }
-    }
-    else {
-        if (has_right(cr, CastlingRights::BlackKingside)) {
-            const Square from = Square::E8;
-            const Square to = Square::G8;
-            const Bitboard fullPath = geom::between_or_to(from, to);
-            if ((state.occ & fullPath) == 0 && !is_any_square_attacked(pos, fullPath, state.them)) {
-                moveList.push_back(Move(from, to, MoveType::CastleKing));
-            }
-        }
-        if (has_right(cr, CastlingRights::BlackQueenside)) {
-            const Square from = Square::E8;
-            const Square to = Square::C8;
-            // Ensure the full path is clear, and that the king's path isn't attacked
-            const Bitboard kingPath = geom::between_or_to(from, to);
-            const Bitboard fullPath = geom::between_or_to(from, Square::B8);
-            if ((state.occ & fullPath) == 0 && !is_any_square_attacked(pos, kingPath, state.them)) {
-                moveList.push_back(Move(from, to, MoveType::CastleQueen));
+            const Bitboard kingPath = geom::between_or_to(kingFrom, queensideTo);
+            const Bitboard fullPath = geom::between_or_to(kingFrom, queensideRookPath);
+            const bool allowed =
+                Mode != GenMode::QuietChecks ||
+                castling_gives_check<Us>(pos, state, kingFrom, queensideTo, queensideRookFrom, queensideRookTo);
+            if (allowed && (state.occ & fullPath) == 0 && !is_any_square_attacked(pos, kingPath, ~Us)) {
+                moveList.push_back(Move(kingFrom, queensideTo, MoveType::CastleQueen));
             }
         }
     }
 }
 
+template <Color Us, bool Pseudo>
 void generate_en_passant_moves(const Position& pos, const State& state, MoveList& moveList) noexcept {
+    constexpr Color Them = ~Us;
+    constexpr Direction Down = (Us == Color::White) ? Direction::South : Direction::North;
+
     const Square epSq = pos.epSquare();
     if (!is_valid(epSq))
         return;
 
     const Square kingSq = state.kingSq;
-    const Color them = state.them;
-    Bitboard pawns = pos.get(state.us, PieceType::Pawn) & attacks::pawn_attacks(them, epSq);
+    const Square capturedPawnSq = epSq + Down;
+    const Bitboard bishops = pos.get<Them, PieceType::Bishop>() | pos.get<Them, PieceType::Queen>();
+    const Bitboard rooks = pos.get<Them, PieceType::Rook>() | pos.get<Them, PieceType::Queen>();
+    Bitboard pawns = pos.get<Us, PieceType::Pawn>() & attacks::pawn_attacks(Them, epSq);
 
     while (pawns) {
         const auto from = static_cast<Square>(pop_lsb(pawns));
         // Only push the move if the en passant capture wouldn't expose the king to check
-        const Direction dir = (state.us == Color::White) ? Direction::South : Direction::North;
-        const Square capturedPawnSq = geom::step(epSq, dir);
-        const Bitboard afterEpOcc = (state.occ ^ bitboard(from) ^ bitboard(capturedPawnSq)) | bitboard(epSq);
-        if (!(attacks::bishop_attacks(kingSq, afterEpOcc) & pos.get(them, PieceType::Bishop)) &&
-            !(attacks::rook_attacks(kingSq, afterEpOcc) & pos.get(them, PieceType::Rook)) &&
-            !(attacks::queen_attacks(kingSq, afterEpOcc) & pos.get(them, PieceType::Queen))) [[likely]] {
-            moveList.push_back(Move(from, epSq, MoveType::EnPassant));
+        if constexpr (!Pseudo) {
+            const Bitboard afterEpOcc = (state.occ ^ bitboard(from) ^ bitboard(capturedPawnSq)) | bitboard(epSq);
+            if ((attacks::bishop_attacks(kingSq, afterEpOcc) & bishops) ||
+                (attacks::rook_attacks(kingSq, afterEpOcc) & rooks)) [[unlikely]] {
+                continue;
+            }
         }
+        moveList.push_back(Move(from, epSq, MoveType::EnPassant));
+    }
+}
+
+template <Color Us, GenMode Mode, bool Pseudo>
+void generate(const Position& pos, MoveList& moveList) noexcept {
+    const State state = init_state<Us, Mode, Pseudo>(pos);
+
+    generate_king_moves<Us, Mode, Pseudo>(pos, state, moveList);
+    // Only king moves possible in double check
+    if (state.numCheckers >= 2)
+        return;
+
+    generate_piece_moves<Us, PieceType::Knight, Mode>(pos, state, moveList);
+    generate_piece_moves<Us, PieceType::Bishop, Mode>(pos, state, moveList);
+    generate_piece_moves<Us, PieceType::Rook, Mode>(pos, state, moveList);
+    generate_piece_moves<Us, PieceType::Queen, Mode>(pos, state, moveList);
+
+    generate_pawn_moves<Us, Mode>(pos, state, moveList);
+
+    generate_castling_moves<Us, Mode>(pos, state, moveList);
+    if constexpr (includes_tactical(Mode))
+        generate_en_passant_moves<Us, Pseudo>(pos, state, moveList);
+}
+
+template <Color Us, bool Pseudo>
+void generate_for_mode(const Position& pos, MoveList& moveList, GenMode mode) noexcept {
+    switch (mode) {
+        case GenMode::Legal:
+            generate<Us, GenMode::Legal, Pseudo>(pos, moveList);
+            break;
+        case GenMode::Tactical:
+            generate<Us, GenMode::Tactical, Pseudo>(pos, moveList);
+            break;
+        case GenMode::Evasions:
+            generate<Us, GenMode::Evasions, Pseudo>(pos, moveList);
+            break;
+        case GenMode::Quiets:
+            generate<Us, GenMode::Quiets, Pseudo>(pos, moveList);
+            break;
+        case GenMode::QuietChecks:
+            generate<Us, GenMode::QuietChecks, Pseudo>(pos, moveList);
+            break;
+        default:
+            assert(false && "Invalid generation mode");
+            break;
     }
 }
 
@@ -314,15 +378,20 @@ Bitboard checkers(const Position& pos, Color us) noexcept {
     const Square kingSq = pos.kingSquare(us);
     const Bitboard occupied = pos.occupancy();
 
+    const Bitboard queens = pos.get(them, PieceType::Queen);
+
     Bitboard checkers = 0;
     checkers |= attacks::pawn_attacks(us, kingSq) & pos.get(them, PieceType::Pawn);
     checkers |= attacks::knight_attacks(kingSq) & pos.get(them, PieceType::Knight);
-    checkers |= attacks::bishop_attacks(kingSq, occupied) & pos.get(them, PieceType::Bishop);
-    checkers |= attacks::rook_attacks(kingSq, occupied) & pos.get(them, PieceType::Rook);
-    checkers |= attacks::queen_attacks(kingSq, occupied) & pos.get(them, PieceType::Queen);
+    checkers |= attacks::bishop_attacks(kingSq, occupied) & (pos.get(them, PieceType::Bishop) | queens);
+    checkers |= attacks::rook_attacks(kingSq, occupied) & (pos.get(them, PieceType::Rook) | queens);
     return checkers;
 }
 
+Bitboard pinned_pieces(const Position& pos, Color us) noexcept {
+    return slider_blockers(pos, pos.kingSquare(us), ~us, us);
+}
+
 bool is_square_attacked(const Position& pos, Square sq, Color by, Bitboard occupied) noexcept {
     return (attacks::pawn_attacks(~by, sq) & pos.get(by, PieceType::Pawn)) ||
            (attacks::knight_attacks(sq) & pos.get(by, PieceType::Knight)) ||
@@ -347,21 +416,16 @@ bool is_any_square_attacked(const Position& pos, Bitboard b, Color by) noexcept
 
 void generate_moves(const Position& pos, MoveList& moveList, GenMode mode) noexcept {
     moveList.clear();
-    const State state = init_state(pos);
-    const GenMode effectiveMode = (state.numCheckers > 0 && mode == GenMode::Tactical) ? GenMode::Evasions : mode;
-
-    generate_king_moves(pos, state, moveList, effectiveMode);
-    // Only king moves possible in double check
-    if (state.numCheckers >= 2)
-        return;
-
-    generate_piece_moves<PieceType::Knight>(pos, state, moveList, effectiveMode);
-    generate_piece_moves<PieceType::Bishop>(pos, state, moveList, effectiveMode);
-    generate_piece_moves<PieceType::Rook>(pos, state, moveList, effectiveMode);
-    generate_piece_moves<PieceType::Queen>(pos, state, moveList, effectiveMode);
-
-    generate_pawn_moves(pos, state, moveList, effectiveMode);
+    if (pos.sideToMove() == Color::White)
+        generate_for_mode<Color::White, false>(pos, moveList, mode);
+    else
+        generate_for_mode<Color::Black, false>(pos, moveList, mode);
+}
 
-    generate_castling_moves(pos, state, moveList, effectiveMode);
-    generate_en_passant_moves(pos, state, moveList);
+void generate_pseudo_legal_moves(const Position& pos, MoveList& moveList, GenMode mode) noexcept {
+    moveList.clear();
+    if (pos.sideToMove() == Color::White)
+        generate_for_mode<Color::White, true>(pos, moveList, mode);
+    else
+        generate_for_mode<Color::Black, true>(pos, moveList, mode);
 }
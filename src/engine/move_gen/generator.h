@@ -8,36 +8,21 @@
 
 struct MoveList;
 
+// Tactical and Quiets partition Legal: every legal move is generated by exactly one of them, in or out of check.
 enum class GenMode : uint8_t {
-    Legal,     // All legal moves
-    Tactical,  // Captures and promotions, but not quiet/normal moves
-    Evasions,  // Moves to get out of check (captures, king moves, and blocking moves)
+    Legal,        // All legal moves
+    Tactical,     // Captures and promotions, but not quiet/normal moves
+    Evasions,     // Moves to get out of check (captures, king moves, and blocking moves)
+    Quiets,       // Non-capturing, non-promotion moves, including castling
+    QuietChecks,  // Quiet moves that give check, directly or by discovery
 
-    Count = 3
+    Count = 5
 };
 
-// Checks if a piece of the given type can move in the given direction
-constexpr bool is_slider_for_direction(PieceType pt, Direction dir) noexcept {
-    switch (dir) {
-        case Direction::North:
-        case Direction::South:
-        case Direction::East:
-        case Direction::West:
-            return pt == PieceType::Rook || pt == PieceType::Queen;
-
-        case Direction::NorthEast:
-        case Direction::NorthWest:
-        case Direction::SouthEast:
-        case Direction::SouthWest:
-            return pt == PieceType::Bishop || pt == PieceType::Queen;
-
-        default:
-            return false;
-    }
-}
-
 // Returns a bitboard of pieces giving check to the king of the given color.
 Bitboard checkers(const Position& pos, Color us) noexcept;
+// Returns a bitboard of the pieces of the given color pinned to their own king.
+Bitboard pinned_pieces(const Position& pos, Color us) noexcept;
 // Checks if the given square is attacked by any piece of the given color, given the occupancy bitboard.
 bool is_square_attacked(const Position& pos, Square sq, Color by, Bitboard occupied) noexcept;
 // Checks if the given square is attacked by any piece of the given color, using the position's occupancy.
@@ -46,6 +31,10 @@ bool is_square_attacked(const Position& pos, Square sq, Color by) noexcept;
 bool is_any_square_attacked(const Position& pos, Bitboard b, Color by) noexcept;
 // Generates all legal moves for the given position and appends them to the move list.
 void generate_moves(const Position& pos, MoveList& moveList, GenMode mode = GenMode::Legal) noexcept;
+// Generates the pseudo-legal moves of the given mode: pins, king moves into attacked squares and en passant captures
+// exposing the king are not filtered out, so each move must pass `Position::isLegal` before being made.
+// Castling and check evasion masks are still fully validated.
+void generate_pseudo_legal_moves(const Position& pos, MoveList& moveList, GenMode mode = GenMode::Legal) noexcept;
 
 // List of moves, with a max size of 256 (max moves in any given position is known to be 218)
 struct MoveList {
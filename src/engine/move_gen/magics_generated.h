@@ -2,75 +2,78 @@
 
 #pragma once
 #include <array>
+#include <cstddef>
 
 #include "magic_types.h"
 
 inline constexpr std::array<Magic, 64> kRookMagics = {
-    {{0x000101010101017e, 0x0080004000908824, 52}, {0x000202020202027c, 0x0040004090002000, 53},
-     {0x000404040404047a, 0x8100084431002000, 53}, {0x0008080808080876, 0x3200040810204200, 53},
-     {0x001010101010106e, 0x0100080030050022, 53}, {0x002020202020205e, 0x40800a0003800400, 53},
-     {0x004040404040403e, 0x0400100800c42201, 53}, {0x008080808080807e, 0x8200004082040861, 52},
-     {0x0001010101017e00, 0x0208800390214000, 53}, {0x0002020202027c00, 0x0080806000400480, 54},
-     {0x0004040404047a00, 0x1000808010002000, 54}, {0x0008080808087600, 0x0aa5001001006088, 54},
-     {0x0010101010106e00, 0x9000800800800401, 54}, {0x0020202020205e00, 0x0006000422001008, 54},
-     {0x0040404040403e00, 0x0001000411000200, 54}, {0x0080808080807e00, 0x0042001204125081, 53},
-     {0x00010101017e0100, 0x8402208000400090, 53}, {0x00020202027c0200, 0xa400898040002000, 54},
-     {0x00040404047a0400, 0x3002020020104180, 54}, {0x0008080808760800, 0x000842000a006210, 54},
-     {0x00101010106e1000, 0x0608808028000400, 54}, {0x00202020205e2000, 0x0209180120041040, 54},
-     {0x00404040403e4000, 0x0100840008102102, 54}, {0x00808080807e8000, 0x2800020010810844, 53},
-     {0x000101017e010100, 0x0880004040002001, 53}, {0x000202027c020200, 0x2040008080200050, 54},
-     {0x000404047a040400, 0x0000c02200120084, 54}, {0x0008080876080800, 0x0800080080300080, 54},
-     {0x001010106e101000, 0x2002240180080080, 54}, {0x002020205e202000, 0x0002014200040830, 54},
-     {0x004040403e404000, 0x0040108400020108, 54}, {0x008080807e808000, 0x80010912000084cc, 53},
-     {0x0001017e01010100, 0x0010244002800183, 53}, {0x0002027c02020200, 0x5001a01008400040, 54},
-     {0x0004047a04040400, 0x0008402082001a00, 54}, {0x0008087608080800, 0x0004802801803000, 54},
-     {0x0010106e10101000, 0x82a0480080802400, 54}, {0x0020205e20202000, 0x0041800600800400, 54},
-     {0x0040403e40404000, 0x09c1010804001002, 54}, {0x0080807e80808000, 0x000500a902000444, 53},
-     {0x00017e0101010100, 0x8000c00880248008, 53}, {0x00027c0202020200, 0x005000c960044000, 54},
-     {0x00047a0404040400, 0x009a008044120020, 54}, {0x0008760808080800, 0x0120100100090020, 54},
-     {0x00106e1010101000, 0x2201000800050010, 54}, {0x00205e2020202000, 0x0802001409820010, 54},
-     {0x00403e4040404000, 0x0809000a00010004, 54}, {0x00807e8080808000, 0x1000024124860004, 53},
-     {0x007e010101010100, 0x00c0400020800080, 53}, {0x007c020202020200, 0x1000208042030200, 54},
-     {0x007a040404040400, 0x0080200084900680, 54}, {0x0076080808080800, 0x2030048010080080, 54},
-     {0x006e101010101000, 0x0020240080180080, 54}, {0x005e202020202000, 0x1294004601004040, 54},
-     {0x003e404040404000, 0x0420800200090080, 54}, {0x007e808080808000, 0x0014142081024200, 53},
-     {0x7e01010101010100, 0x0140228000114705, 52}, {0x7c02020202020200, 0x0020a24601110082, 53},
-     {0x7a04040404040400, 0x9000200100411009, 53}, {0x7608080808080800, 0x0002601001184501, 53},
-     {0x6e10101010101000, 0x000e00204c089002, 53}, {0x5e20202020202000, 0x0002004408011002, 53},
-     {0x3e40404040404000, 0x0000011002209804, 53}, {0x7e80808080808000, 0x0090040080310046, 52}}
+    {{0x000101010101017e, 0x0080004000908824, 52, 0}, {0x000202020202027c, 0x0040004090002000, 53, 4096},
+     {0x000404040404047a, 0x8100084431002000, 53, 6144}, {0x0008080808080876, 0x3200040810204200, 53, 8192},
+     {0x001010101010106e, 0x0100080030050022, 53, 10240}, {0x002020202020205e, 0x40800a0003800400, 53, 12288},
+     {0x004040404040403e, 0x0400100800c42201, 53, 14336}, {0x008080808080807e, 0x8200004082040861, 52, 16384},
+     {0x0001010101017e00, 0x0208800390214000, 53, 20480}, {0x0002020202027c00, 0x0080806000400480, 54, 22528},
+     {0x0004040404047a00, 0x1000808010002000, 54, 23552}, {0x0008080808087600, 0x0aa5001001006088, 54, 24576},
+     {0x0010101010106e00, 0x9000800800800401, 54, 25600}, {0x0020202020205e00, 0x0006000422001008, 54, 26624},
+     {0x0040404040403e00, 0x0001000411000200, 54, 27648}, {0x0080808080807e00, 0x0042001204125081, 53, 28672},
+     {0x00010101017e0100, 0x8402208000400090, 53, 30720}, {0x00020202027c0200, 0xa400898040002000, 54, 32768},
+     {0x00040404047a0400, 0x3002020020104180, 54, 33792}, {0x0008080808760800, 0x000842000a006210, 54, 34816},
+     {0x00101010106e1000, 0x0608808028000400, 54, 35840}, {0x00202020205e2000, 0x0209180120041040, 54, 36864},
+     {0x00404040403e4000, 0x0100840008102102, 54, 37888}, {0x00808080807e8000, 0x2800020010810844, 53, 38912},
+     {0x000101017e010100, 0x0880004040002001, 53, 40960}, {0x000202027c020200, 0x2040008080200050, 54, 43008},
+     {0x000404047a040400, 0x0000c02200120084, 54, 44032}, {0x0008080876080800, 0x0800080080300080, 54, 45056},
+     {0x001010106e101000, 0x2002240180080080, 54, 46080}, {0x002020205e202000, 0x0002014200040830, 54, 47104},
+     {0x004040403e404000, 0x0040108400020108, 54, 48128}, {0x008080807e808000, 0x80010912000084cc, 53, 49152},
+     {0x0001017e01010100, 0x0010244002800183, 53, 51200}, {0x0002027c02020200, 0x5001a01008400040, 54, 53248},
+     {0x0004047a04040400, 0x0008402082001a00, 54, 54272}, {0x0008087608080800, 0x0004802801803000, 54, 55296},
+     {0x0010106e10101000, 0x82a0480080802400, 54, 56320}, {0x0020205e20202000, 0x0041800600800400, 54, 57344},
+     {0x0040403e40404000, 0x09c1010804001002, 54, 58368}, {0x0080807e80808000, 0x000500a902000444, 53, 59392},
+     {0x00017e0101010100, 0x8000c00880248008, 53, 61440}, {0x00027c0202020200, 0x005000c960044000, 54, 63488},
+     {0x00047a0404040400, 0x009a008044120020, 54, 64512}, {0x0008760808080800, 0x0120100100090020, 54, 65536},
+     {0x00106e1010101000, 0x2201000800050010, 54, 66560}, {0x00205e2020202000, 0x0802001409820010, 54, 67584},
+     {0x00403e4040404000, 0x0809000a00010004, 54, 68608}, {0x00807e8080808000, 0x1000024124860004, 53, 69632},
+     {0x007e010101010100, 0x00c0400020800080, 53, 71680}, {0x007c020202020200, 0x1000208042030200, 54, 73728},
+     {0x007a040404040400, 0x0080200084900680, 54, 74752}, {0x0076080808080800, 0x2030048010080080, 54, 75776},
+     {0x006e101010101000, 0x0020240080180080, 54, 76800}, {0x005e202020202000, 0x1294004601004040, 54, 77824},
+     {0x003e404040404000, 0x0420800200090080, 54, 78848}, {0x007e808080808000, 0x0014142081024200, 53, 79872},
+     {0x7e01010101010100, 0x0140228000114705, 52, 81920}, {0x7c02020202020200, 0x0020a24601110082, 53, 86016},
+     {0x7a04040404040400, 0x9000200100411009, 53, 88064}, {0x7608080808080800, 0x0002601001184501, 53, 90112},
+     {0x6e10101010101000, 0x000e00204c089002, 53, 92160}, {0x5e20202020202000, 0x0002004408011002, 53, 94208},
+     {0x3e40404040404000, 0x0000011002209804, 53, 96256}, {0x7e80808080808000, 0x0090040080310046, 52, 98304}}
 };
+inline constexpr size_t kRookTableSize = 102400;
 
 inline constexpr std::array<Magic, 64> kBishopMagics = {
-    {{0x0040201008040200, 0x0054206612020111, 58}, {0x0000402010080400, 0x8082081931020000, 59},
-     {0x0000004020100a00, 0x4008018102000010, 59}, {0x0000000040221400, 0x0804040280900104, 59},
-     {0x0000000002442800, 0x0044102828000800, 59}, {0x0000000204085000, 0x011082104102051c, 59},
-     {0x0000020408102000, 0x0000868820100401, 59}, {0x0002040810204000, 0x04001900f0042008, 58},
-     {0x0020100804020000, 0x000004100c610404, 59}, {0x0040201008040000, 0x200020010c010848, 59},
-     {0x00004020100a0000, 0x4004500102490202, 59}, {0x0000004022140000, 0x020404404c800200, 59},
-     {0x0000000244280000, 0x2040740504000088, 59}, {0x0000020408500000, 0x1808808620204280, 59},
-     {0x0002040810200000, 0x2450010082206280, 59}, {0x0004081020400000, 0x20b08d0400820900, 59},
-     {0x0010080402000200, 0x0114101020180102, 59}, {0x0020100804000400, 0x0808810348080280, 59},
-     {0x004020100a000a00, 0x048800100080a348, 57}, {0x0000402214001400, 0x0208004402c10801, 57},
-     {0x0000024428002800, 0x0820800400a008c0, 57}, {0x0002040850005000, 0x02220011080a0600, 57},
-     {0x0004081020002000, 0x000c009104514404, 59}, {0x0008102040004000, 0x0909000020982409, 59},
-     {0x0008040200020400, 0x09642020400a0401, 59}, {0x0010080400040800, 0x4430101a24214222, 59},
-     {0x0020100a000a1000, 0x4000300606040140, 57}, {0x0040221400142200, 0x1000806018020020, 55},
-     {0x0002442800284400, 0x004a8a004c010401, 55}, {0x0004085000500800, 0x0001244008080804, 57},
-     {0x0008102000201000, 0x000445008c00a200, 59}, {0x0010204000402000, 0x0010802100841422, 59},
-     {0x0004020002040800, 0x1201201800200901, 59}, {0x0008040004081000, 0x4002080400021000, 59},
-     {0x00100a000a102000, 0x0001040112020800, 57}, {0x0022140014224000, 0x0400120082480080, 55},
-     {0x0044280028440200, 0x3020060400008028, 55}, {0x0008500050080400, 0x2420004300828094, 57},
-     {0x0010200020100800, 0x101002818022020e, 59}, {0x0020400040201000, 0x0108610104012081, 59},
-     {0x0002000204081000, 0x150202202104a410, 59}, {0x0004000408102000, 0x08710521200010a0, 59},
-     {0x000a000a10204000, 0x0000120101009000, 57}, {0x0014001422400000, 0x000400420800a282, 57},
-     {0x0028002844020000, 0x8322080100410400, 57}, {0x0050005008040200, 0x3010204a80a00101, 57},
-     {0x0020002010080400, 0xc820010111000201, 59}, {0x0040004020100800, 0x0010040840500080, 59},
-     {0x0000020408102000, 0x00220d50080c0151, 59}, {0x0000040810204000, 0x00010c01c2080024, 59},
-     {0x00000a1020400000, 0xa220820203040404, 59}, {0x0000142240000000, 0x4812000084110000, 59},
-     {0x0000284402000000, 0x0202404028320002, 59}, {0x0000500804020000, 0x8480c05408098540, 59},
-     {0x0000201008040200, 0x959010070800a000, 59}, {0x0000402010080400, 0x024a040404014040, 59},
-     {0x0002040810204000, 0x1200804800901830, 58}, {0x0004081020400000, 0x0e80c04108011160, 59},
-     {0x000a102040000000, 0x62804918c2009000, 59}, {0x0014224000000000, 0x0005408010420201, 59},
-     {0x0028440200000000, 0x0080140009030401, 59}, {0x0050080402000000, 0x000d010610020200, 59},
-     {0x0020100804020000, 0x0424111002080040, 59}, {0x0040201008040200, 0x4070010208004101, 58}}
+    {{0x0040201008040200, 0x0054206612020111, 58, 0}, {0x0000402010080400, 0x8082081931020000, 59, 64},
+     {0x0000004020100a00, 0x4008018102000010, 59, 96}, {0x0000000040221400, 0x0804040280900104, 59, 128},
+     {0x0000000002442800, 0x0044102828000800, 59, 160}, {0x0000000204085000, 0x011082104102051c, 59, 192},
+     {0x0000020408102000, 0x0000868820100401, 59, 224}, {0x0002040810204000, 0x04001900f0042008, 58, 256},
+     {0x0020100804020000, 0x000004100c610404, 59, 320}, {0x0040201008040000, 0x200020010c010848, 59, 352},
+     {0x00004020100a0000, 0x4004500102490202, 59, 384}, {0x0000004022140000, 0x020404404c800200, 59, 416},
+     {0x0000000244280000, 0x2040740504000088, 59, 448}, {0x0000020408500000, 0x1808808620204280, 59, 480},
+     {0x0002040810200000, 0x2450010082206280, 59, 512}, {0x0004081020400000, 0x20b08d0400820900, 59, 544},
+     {0x0010080402000200, 0x0114101020180102, 59, 576}, {0x0020100804000400, 0x0808810348080280, 59, 608},
+     {0x004020100a000a00, 0x048800100080a348, 57, 640}, {0x0000402214001400, 0x0208004402c10801, 57, 768},
+     {0x0000024428002800, 0x0820800400a008c0, 57, 896}, {0x0002040850005000, 0x02220011080a0600, 57, 1024},
+     {0x0004081020002000, 0x000c009104514404, 59, 1152}, {0x0008102040004000, 0x0909000020982409, 59, 1184},
+     {0x0008040200020400, 0x09642020400a0401, 59, 1216}, {0x0010080400040800, 0x4430101a24214222, 59, 1248},
+     {0x0020100a000a1000, 0x4000300606040140, 57, 1280}, {0x0040221400142200, 0x1000806018020020, 55, 1408},
+     {0x0002442800284400, 0x004a8a004c010401, 55, 1920}, {0x0004085000500800, 0x0001244008080804, 57, 2432},
+     {0x0008102000201000, 0x000445008c00a200, 59, 2560}, {0x0010204000402000, 0x0010802100841422, 59, 2592},
+     {0x0004020002040800, 0x1201201800200901, 59, 2624}, {0x0008040004081000, 0x4002080400021000, 59, 2656},
+     {0x00100a000a102000, 0x0001040112020800, 57, 2688}, {0x0022140014224000, 0x0400120082480080, 55, 2816},
+     {0x0044280028440200, 0x3020060400008028, 55, 3328}, {0x0008500050080400, 0x2420004300828094, 57, 3840},
+     {0x0010200020100800, 0x101002818022020e, 59, 3968}, {0x0020400040201000, 0x0108610104012081, 59, 4000},
+     {0x0002000204081000, 0x150202202104a410, 59, 4032}, {0x0004000408102000, 0x08710521200010a0, 59, 4064},
+     {0x000a000a10204000, 0x0000120101009000, 57, 4096}, {0x0014001422400000, 0x000400420800a282, 57, 4224},
+     {0x0028002844020000, 0x8322080100410400, 57, 4352}, {0x0050005008040200, 0x3010204a80a00101, 57, 4480},
+     {0x0020002010080400, 0xc820010111000201, 59, 4608}, {0x0040004020100800, 0x0010040840500080, 59, 4640},
+     {0x0000020408102000, 0x00220d50080c0151, 59, 4672}, {0x0000040810204000, 0x00010c01c2080024, 59, 4704},
+     {0x00000a1020400000, 0xa220820203040404, 59, 4736}, {0x0000142240000000, 0x4812000084110000, 59, 4768},
+     {0x0000284402000000, 0x0202404028320002, 59, 4800}, {0x0000500804020000, 0x8480c05408098540, 59, 4832},
+     {0x0000201008040200, 0x959010070800a000, 59, 4864}, {0x0000402010080400, 0x024a040404014040, 59, 4896},
+     {0x0002040810204000, 0x1200804800901830, 58, 4928}, {0x0004081020400000, 0x0e80c04108011160, 59, 4992},
+     {0x000a102040000000, 0x62804918c2009000, 59, 5024}, {0x0014224000000000, 0x0005408010420201, 59, 5056},
+     {0x0028440200000000, 0x0080140009030401, 59, 5088}, {0x0050080402000000, 0x000d010610020200, 59, 5120},
+     {0x0020100804020000, 0x0424111002080040, 59, 5152}, {0x0040201008040200, 0x4070010208004101, 58, 5184}}
 };
+inline constexpr size_t kBishopTableSize = 5248;
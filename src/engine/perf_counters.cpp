@@ -0,0 +1,134 @@
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <format>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace engine {
+
+namespace {
+
+// Indexed by PerfEvent
+constexpr std::array<const char*, to_underlying(PerfEvent::Count)> kEventNames = {
+    "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "dtlb_misses",
+};
+
+#if defined(__linux__)
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) noexcept {
+    return cache | (op << 8) | (result << 16);
+}
+
+// Indexed by PerfEvent
+constexpr std::array<EventConfig, to_underlying(PerfEvent::Count)> kEventConfigs = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE,
+     cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE,
+     cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+}};
+
+int open_event(const EventConfig& event) noexcept {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+}  // namespace
+
+PerfCounters::PerfCounters() noexcept {
+    fds_.fill(-1);
+#if defined(__linux__)
+    for (size_t i = 0; i < fds_.size(); ++i) {
+        fds_[i] = open_event(kEventConfigs[i]);
+        if (fds_[i] < 0 && error_.empty())
+            error_ = std::format("perf_event_open failed for {}: {}", kEventNames[i], std::strerror(errno));
+    }
+#else
+    error_ = "hardware performance counters require Linux perf_event_open";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (const int fd : fds_) {
+        if (fd >= 0)
+            close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::available() const noexcept {
+    return std::ranges::any_of(fds_, [](int fd) { return fd >= 0; });
+}
+
+PerfCounterSample PerfCounters::read() const noexcept {
+    PerfCounterSample sample;
+#if defined(__linux__)
+    for (size_t i = 0; i < fds_.size(); ++i) {
+        // value, time enabled, time running
+        std::array<uint64_t, 3> data{};
+        if (fds_[i] < 0 || ::read(fds_[i], data.data(), sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+            continue;
+
+        const auto [value, enabled, running] = data;
+        if (running == 0)
+            continue;
+        // Extrapolate events that only had part of the time on a hardware counter
+        const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+        sample.values[i] = running < enabled ? static_cast<uint64_t>(static_cast<double>(value) * scale) : value;
+    }
+#endif
+    return sample;
+}
+
+std::string format_perf_counters(const PerfCounterSample& sample, uint64_t nodes) {
+    std::string out;
+    for (size_t i = 0; i < kEventNames.size(); ++i) {
+        const auto& value = sample.values[i];
+        out += std::format("{}{}={}", out.empty() ? "" : " ", kEventNames[i], value ? std::to_string(*value) : "n/a");
+    }
+
+    const auto cycles = sample[PerfEvent::Cycles];
+    const auto instructions = sample[PerfEvent::Instructions];
+    if (cycles && instructions && *cycles > 0)
+        out += std::format(" ipc={:.2f}", static_cast<double>(*instructions) / static_cast<double>(*cycles));
+    else
+        out += " ipc=n/a";
+
+    for (size_t i = 0; i < kEventNames.size(); ++i) {
+        const auto& value = sample.values[i];
+        if (value && nodes > 0) {
+            const double perNode = static_cast<double>(*value) / static_cast<double>(nodes);
+            out += std::format(" {}_per_node={:.3f}", kEventNames[i], perNode);
+        }
+        else {
+            out += std::format(" {}_per_node=n/a", kEventNames[i]);
+        }
+    }
+    return out;
+}
+
+}  // namespace engine
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "types.h"
+
+namespace engine {
+
+enum class PerfEvent : uint8_t {
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1DMisses,   // L1 data cache read misses
+    LLCMisses,   // Last level cache misses
+    DTLBMisses,  // Data TLB read misses
+
+    Count = 6
+};
+
+// Counter totals of one measured region. An event is empty when the kernel or CPU does not provide it, or when it was
+// never scheduled on the PMU. Values are scaled up when events had to be multiplexed.
+struct PerfCounterSample {
+    std::array<std::optional<uint64_t>, to_underlying(PerfEvent::Count)> values{};
+
+    std::optional<uint64_t> operator[](PerfEvent event) const noexcept { return values[to_underlying(event)]; }
+};
+
+// Hardware performance counters read through Linux `perf_event_open`, counting user-space events only so that the
+// default `perf_event_paranoid` level of 2 suffices.
+// Counting starts at construction and covers the calling thread plus every thread it spawns afterwards (the counters
+// are inherited), so construct it on the thread that launches the search workers. The counts of a spawned thread are
+// only added once it has exited, so join the workers before calling `read`.
+class PerfCounters {
+public:
+    PerfCounters() noexcept;
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    PerfCounters(PerfCounters&&) = delete;
+    PerfCounters& operator=(PerfCounters&&) = delete;
+
+    // Whether at least one event could be opened; otherwise `error` describes why.
+    bool available() const noexcept;
+    const std::string& error() const noexcept { return error_; }
+
+    PerfCounterSample read() const noexcept;
+
+private:
+    std::array<int, to_underlying(PerfEvent::Count)> fds_{};
+    std::string error_;
+};
+
+// Formats the sample as space separated `key=value` pairs: totals, IPC and the per-node rate of every event.
+// Unavailable events are reported as `n/a`.
+std::string format_perf_counters(const PerfCounterSample& sample, uint64_t nodes);
+
+}  // namespace engine
@@ -0,0 +1,125 @@
+#include "perft.h"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+#include "move_gen/generator.h"
+
+namespace engine {
+
+namespace {
+
+constexpr uint64_t kMaxPackedNodes = (uint64_t{1} << 56) - 1;
+
+}  // namespace
+
+void PerftTable::resize(size_t sizeMB) {
+    if (sizeMB == 0) {
+        table_.clear();
+        mask_ = 0;
+        return;
+    }
+
+    // Round size down to nearest power of two for efficient indexing
+    const size_t entries = std::bit_floor(sizeMB * 1024 * 1024 / sizeof(std::atomic<PackedEntry>));
+    table_ = std::vector<std::atomic<PackedEntry>>(entries);
+    mask_ = entries - 1;
+    clear();
+}
+
+void PerftTable::clear() noexcept {
+    for (std::atomic<PackedEntry>& entry : table_)
+        entry.store(static_cast<PackedEntry>(0), std::memory_order_relaxed);
+}
+
+std::optional<uint64_t> PerftTable::probe(Key key, Depth depth) const noexcept {
+    if (empty())
+        return std::nullopt;
+
+    const PackedEntry entry = table_[key & mask_].load(std::memory_order_relaxed);
+    if (static_cast<Key>(entry) != key || static_cast<Depth>((entry >> 64) & 0xFF) != depth)
+        return std::nullopt;
+
+    return static_cast<uint64_t>(entry >> 72);
+}
+
+void PerftTable::store(Key key, Depth depth, uint64_t nodes) noexcept {
+    // Counts too large to pack are simply not cached
+    if (empty() || nodes > kMaxPackedNodes)
+        return;
+
+    // Always replace: the most recently finished subtree is the most likely to be transposed into next
+    const PackedEntry entry = static_cast<PackedEntry>(key) | (static_cast<PackedEntry>(depth & 0xFF) << 64) |
+                              (static_cast<PackedEntry>(nodes) << 72);
+    table_[key & mask_].store(entry, std::memory_order_relaxed);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+uint64_t perft(Position& pos, Depth depth, PerftTable* table) noexcept {
+    if (depth <= 0)
+        return 1;
+
+    const MoveList moves(pos);
+    if (depth == 1)
+        return moves.size();
+
+    if (table != nullptr) {
+        if (const auto cached = table->probe(pos.hash(), depth))
+            return *cached;
+    }
+
+    uint64_t nodes = 0;
+    for (const Move m : moves) {
+        UndoInfo u{};
+        pos.makeMove(m, u);
+        nodes += perft(pos, depth - 1, table);
+        pos.undoMove(m, u);
+    }
+
+    if (table != nullptr)
+        table->store(pos.hash(), depth, nodes);
+    return nodes;
+}
+
+PerftResult run_perft(const Position& root, Depth depth, int threads, PerftTable* table) {
+    const auto start = std::chrono::steady_clock::now();
+
+    PerftResult result;
+    if (depth <= 0) {
+        result.nodes = 1;
+        return result;
+    }
+
+    const MoveList moves(root);
+    result.divide.reserve(moves.size());
+    for (const Move m : moves)
+        result.divide.emplace_back(m, 0);
+
+    // Workers claim root moves one at a time, so a few large subtrees do not leave the other threads idle
+    std::atomic<size_t> nextMove{0};
+    const size_t workerCount = std::min(static_cast<size_t>(std::max(threads, 1)), result.divide.size());
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(workerCount);
+        for (size_t t = 0; t < workerCount; ++t) {
+            workers.emplace_back([&] {
+                Position pos = root;
+                for (size_t i = nextMove.fetch_add(1); i < result.divide.size(); i = nextMove.fetch_add(1)) {
+                    auto& [move, nodes] = result.divide[i];
+                    UndoInfo u{};
+                    pos.makeMove(move, u);
+                    nodes = perft(pos, depth - 1, table);
+                    pos.undoMove(move, u);
+                }
+            });
+        }
+    }
+
+    for (const auto& [move, nodes] : result.divide)
+        result.nodes += nodes;
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+}  // namespace engine
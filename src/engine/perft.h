@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "position.h"
+#include "types.h"
+
+namespace engine {
+
+// Shared hash table of subtree leaf counts (hash + depth -> nodes), used to collapse transpositions in perft.
+// Entries are single 128-bit atomics like the transposition table, so worker threads can share it without locks.
+//
+// An entry is packed into 128 bits as follows:
+// Bits 0-63:       Hash key
+// Bits 64-71:      Depth
+// Bits 72-127:     Leaf node count
+class PerftTable {
+public:
+    PerftTable() noexcept = default;
+    explicit PerftTable(size_t sizeMB) { resize(sizeMB); }
+    void resize(size_t sizeMB);
+    void clear() noexcept;
+    bool empty() const noexcept { return table_.empty(); }
+
+    std::optional<uint64_t> probe(Key key, Depth depth) const noexcept;
+    void store(Key key, Depth depth, uint64_t nodes) noexcept;
+
+private:
+    using PackedEntry = __uint128_t;
+
+    std::vector<std::atomic<PackedEntry>> table_;
+    size_t mask_{};
+};
+
+struct PerftResult {
+    uint64_t nodes{};
+    std::vector<std::pair<Move, uint64_t>> divide;  // Leaf count below each root move, in generation order
+    std::chrono::microseconds elapsed{};
+
+    uint64_t nps() const noexcept {
+        const auto us = static_cast<uint64_t>(elapsed.count());
+        return us == 0 ? nodes : nodes * 1'000'000 / us;
+    }
+};
+
+// Counts the leaf nodes `depth` plies below `pos`. The last ply is bulk counted from the move list size, and subtrees
+// are looked up in / stored to `table` when given.
+uint64_t perft(Position& pos, Depth depth, PerftTable* table = nullptr) noexcept;
+
+// Runs perft with the root moves split across `threads` workers, all sharing `table` when given.
+PerftResult run_perft(const Position& root, Depth depth, int threads = 1, PerftTable* table = nullptr);
+
+}  // namespace engine
@@ -55,6 +55,7 @@ Position Position::fromFEN(std::string_view fen) {
         pos.fullmoveNumber_ = std::stoi(std::string(fields[5]));
 
     pos.hash_ = pos.computeHash();
+    pos.updateCheckInfo_();
 
     return pos;
 }
@@ -156,6 +157,7 @@ bool Position::hasLegalEnPassant_() const noexcept {
         return false;
     Position opponent = *this;
     opponent.sideToMove_ = ~opponent.sideToMove_;
+    opponent.updateCheckInfo_();
     MoveList moves(opponent);
     return std::ranges::any_of(moves, [](const Move m) { return m.moveType() == MoveType::EnPassant; });
 }
@@ -166,6 +168,7 @@ void Position::makeMove(Move m, UndoInfo& undo) noexcept {
         .castlingRights = castlingRights_,
         .enPassantSquare = enPassantSquare_,
         .halfmoveClock = halfmoveClock_,
+        .checkInfo = checkInfo_,
     };
 
     const Square from = m.from();
@@ -259,6 +262,8 @@ void Position::makeMove(Move m, UndoInfo& undo) noexcept {
 
     sideToMove_ = ~sideToMove_;
     hash_ ^= zobrist::side;
+
+    updateCheckInfo_();
 }
 
 void Position::undoMove(Move m, const UndoInfo& undo) noexcept {
@@ -345,6 +350,115 @@ void Position::undoMove(Move m, const UndoInfo& undo) noexcept {
             break;
     }
     kingSquare_[to_underlying(sideToMove_)] = static_cast<Square>(get_lsb(get(sideToMove_, PieceType::King)));
+    checkInfo_ = undo.checkInfo;
+}
+
+bool Position::isPseudoLegal(Move m) const noexcept {
+    const Color us = sideToMove_;
+    const Square from = m.from();
+    const Square to = m.to();
+    const MoveType type = m.moveType();
+    const Piece piece = pieceOn(from);
+
+    if (m.isNone() || from == to || is_empty(piece) || color(piece) != us)
+        return false;
+
+    const PieceType pt = piece_type(piece);
+    const Bitboard toBB = bitboard(to);
+    const bool inCheck = checkInfo_.checkers != 0;
+
+    if (type == MoveType::CastleKing || type == MoveType::CastleQueen) {
+        const bool kingside = type == MoveType::CastleKing;
+        const bool white = us == Color::White;
+        const CastlingRights right = white ? (kingside ? CastlingRights::WhiteKingside : CastlingRights::WhiteQueenside)
+                                           : (kingside ? CastlingRights::BlackKingside : CastlingRights::BlackQueenside);
+        const Square kingFrom = white ? Square::E1 : Square::E8;
+        const Square kingTo = white ? (kingside ? Square::G1 : Square::C1) : (kingside ? Square::G8 : Square::C8);
+        const Square pathEnd = white ? (kingside ? Square::G1 : Square::B1) : (kingside ? Square::G8 : Square::B8);
+        if (pt != PieceType::King || from != kingFrom || to != kingTo || inCheck || !has_right(castlingRights_, right))
+            return false;
+
+        // Same checks as the generator: the full path to the rook is empty and the king never crosses an attacked square
+        return (occupied_ & geom::between_or_to(kingFrom, pathEnd)) == 0 &&
+               !is_any_square_attacked(*this, geom::between_or_to(kingFrom, kingTo), ~us);
+    }
+
+    // En passant is not restricted to the evasion squares, as the generator leaves its discovered-check cases to
+    // `isLegal`, but like all non-king moves it cannot escape a double check
+    if (type == MoveType::EnPassant) {
+        return pt == PieceType::Pawn && to == enPassantSquare_ && (attacks::pawn_attacks(us, from) & toBB) &&
+               !more_than_one(checkInfo_.checkers);
+    }
+
+    // In check, other non-king moves must capture or block a single checker
+    if (inCheck && pt != PieceType::King) {
+        if (more_than_one(checkInfo_.checkers))
+            return false;
+        const auto checkerSq = static_cast<Square>(get_lsb(checkInfo_.checkers));
+        const PieceType checker = piece_type(pieceOn(checkerSq));
+        Bitboard evasionMask = checkInfo_.checkers;
+        if (checker == PieceType::Bishop || checker == PieceType::Rook || checker == PieceType::Queen)
+            evasionMask |= geom::between(kingSquare(us), checkerSq);
+        if (!(evasionMask & toBB))
+            return false;
+    }
+
+    // The capture flag must match the target square, which can never hold one of our own pieces
+    if (colorOccupied_[to_underlying(us)] & toBB)
+        return false;
+    if (m.isCapture() != static_cast<bool>(colorOccupied_[to_underlying(~us)] & toBB))
+        return false;
+
+    if (pt == PieceType::Pawn) {
+        const Bitboard promotionRank = bitboard(us == Color::White ? Rank::R8 : Rank::R1);
+        if (m.isPromotion() != static_cast<bool>(promotionRank & toBB))
+            return false;
+
+        const int push = (us == Color::White) ? 8 : -8;
+        const int delta = to_underlying(to) - to_underlying(from);
+        if (m.isCapture())
+            return (type == MoveType::Capture || m.isPromotion()) && (attacks::pawn_attacks(us, from) & toBB);
+        if (type == MoveType::PawnDoubleStep) {
+            const Rank startRank = (us == Color::White) ? Rank::R2 : Rank::R7;
+            const auto stepSq = static_cast<Square>(to_underlying(from) + push);
+            return rank(from) == startRank && delta == 2 * push && is_empty(pieceOn(stepSq));
+        }
+        // Remaining types are single pushes: `Normal` or a non-capturing promotion
+        return delta == push;
+    }
+
+    // Pieces only make normal moves and captures
+    if (type != MoveType::Normal && type != MoveType::Capture)
+        return false;
+    if (pt == PieceType::King)
+        return (attacks::king_attacks(from) & toBB) != 0;
+    return (attacks::piece_attacks(pt, from, occupied_) & toBB) != 0;
+}
+
+bool Position::isLegal(Move m) const noexcept {
+    const Color us = sideToMove_;
+    const Square from = m.from();
+    const Square to = m.to();
+    const Square kingSq = kingSquare(us);
+
+    // En passant removes two pieces from their squares, so check for sliders through the resulting occupancy
+    if (m.moveType() == MoveType::EnPassant) {
+        const Square capturedSq = to + ((us == Color::White) ? Direction::South : Direction::North);
+        const Bitboard afterOcc = (occupied_ ^ bitboard(from) ^ bitboard(capturedSq)) | bitboard(to);
+        const Bitboard queens = get(~us, PieceType::Queen);
+        return !(attacks::bishop_attacks(kingSq, afterOcc) & (get(~us, PieceType::Bishop) | queens)) &&
+               !(attacks::rook_attacks(kingSq, afterOcc) & (get(~us, PieceType::Rook) | queens));
+    }
+
+    // Castling paths are validated during generation; other king moves must not land on an attacked square
+    if (from == kingSq) {
+        if (m.moveType() == MoveType::CastleKing || m.moveType() == MoveType::CastleQueen)
+            return true;
+        return !is_square_attacked(*this, to, ~us, occupied_ ^ bitboard(from));
+    }
+
+    // A pinned piece may only move along the line through its king
+    return !(checkInfo_.pinned & bitboard(from)) || (geom::line(kingSq, from) & bitboard(to));
 }
 
 void Position::removePiece_(Square sq) noexcept {
@@ -370,8 +484,20 @@ void Position::movePiece_(Square from, Square to) noexcept {
     putPiece_(to, piece);
 }
 
-bool Position::inCheck() const noexcept {
-    return is_square_attacked(*this, kingSquare(sideToMove_), ~sideToMove_);
+void Position::updateCheckInfo_() noexcept {
+    const Square theirKing = kingSquare(~sideToMove_);
+    auto& checkSquares = checkInfo_.checkSquares;
+
+    checkInfo_.checkers = ::checkers(*this, sideToMove_);
+    checkInfo_.pinned = pinned_pieces(*this, sideToMove_);
+
+    checkSquares[to_underlying(PieceType::Pawn)] = attacks::pawn_attacks(~sideToMove_, theirKing);
+    checkSquares[to_underlying(PieceType::Knight)] = attacks::knight_attacks(theirKing);
+    checkSquares[to_underlying(PieceType::Bishop)] = attacks::bishop_attacks(theirKing, occupied_);
+    checkSquares[to_underlying(PieceType::Rook)] = attacks::rook_attacks(theirKing, occupied_);
+    checkSquares[to_underlying(PieceType::Queen)] =
+        checkSquares[to_underlying(PieceType::Bishop)] | checkSquares[to_underlying(PieceType::Rook)];
+    checkSquares[to_underlying(PieceType::King)] = 0;
 }
 
 Key Position::computeHash() const noexcept {
@@ -3,13 +3,22 @@
 
 #include "types.h"
 
+// Check state of the side to move, computed once per move and shared by the search and move generation.
+struct CheckInfo {
+    Bitboard checkers{};  // Enemy pieces giving check
+    Bitboard pinned{};    // Own pieces pinned to the king
+    // Squares from which a piece of each type would give check to the enemy king
+    std::array<Bitboard, to_underlying(PieceType::Count)> checkSquares{};
+};
+
 struct UndoInfo {
     Piece captured = Piece::None;
     CastlingRights castlingRights{};
     Square enPassantSquare = Square::None;
     uint8_t halfmoveClock{};
+    CheckInfo checkInfo{};  // Restored on undo rather than recomputed
 };
-static_assert(sizeof(UndoInfo) == 4);
+static_assert(sizeof(UndoInfo) == 80);
 
 struct Position {
     // Returns the bitboard of pieces of the given color and piece type.
@@ -54,7 +63,20 @@ struct Position {
     void makeMove(Move m, UndoInfo& undo) noexcept;
     // Undoes the given move using the provided undo information, restoring the position to its previous state.
     void undoMove(Move m, const UndoInfo& undo) noexcept;
-    bool inCheck() const noexcept;
+    // Returns the enemy pieces giving check to the king of the side to move.
+    constexpr Bitboard checkers() const noexcept { return checkInfo_.checkers; }
+    // Returns the pieces of the side to move that are pinned to their own king.
+    constexpr Bitboard pinned() const noexcept { return checkInfo_.pinned; }
+    // Returns the squares from which a piece of the given type of the side to move would give check.
+    constexpr Bitboard checkSquares(PieceType pt) const noexcept {
+        assert(is_valid(pt));
+        return checkInfo_.checkSquares[to_underlying(pt)];
+    }
+    constexpr bool inCheck() const noexcept { return checkInfo_.checkers != 0; }
+    // Checks if an arbitrary move, e.g. from the TT or a killer slot, is one `generate_pseudo_legal_moves` would generate.
+    bool isPseudoLegal(Move m) const noexcept;
+    // Checks if a pseudo-legal move (see `generate_pseudo_legal_moves`) leaves the own king safe.
+    bool isLegal(Move m) const noexcept;
     // Computes the Zobrist hash of the position. Only needed at initialization, as the hash is updated incrementally.
     Key computeHash() const noexcept;
 
@@ -70,6 +92,7 @@ private:
     uint8_t halfmoveClock_;
     Square enPassantSquare_;  // Candidate en passant square
     Key hash_;
+    CheckInfo checkInfo_;
 
     void parsePieceMap_(std::string_view placement) noexcept;
     void parseCastlingRights_(std::string_view castling) noexcept;
@@ -78,8 +101,10 @@ private:
     void removePiece_(Square sq) noexcept;
     void putPiece_(Square sq, Piece piece) noexcept;
     void movePiece_(Square from, Square to) noexcept;
+    // Recomputes the checkers, pinned pieces and check squares for the side to move.
+    void updateCheckInfo_() noexcept;
     // Checks if the position has a legal en passant move by generating and validating moves as the opponent.
     // Should only be used in `toFEN()` or testing, as it requires move generation and is slow.
     bool hasLegalEnPassant_() const noexcept;
 };
-static_assert(sizeof(Position) == 200);
+static_assert(sizeof(Position) == 272);
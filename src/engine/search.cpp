@@ -1,6 +1,10 @@
 #include "search.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "evaluation.h"
+#include "trace.h"
 
 namespace {
 
@@ -27,6 +31,36 @@ Eval qsearch_gain(const Position& pos, Move move) noexcept {
 
 namespace engine {
 
+void SearchTreeStats::merge(const SearchTreeStats& other) noexcept {
+    for (size_t i = 0; i < kDepthBuckets; ++i) {
+        betaCutoffs[i] += other.betaCutoffs[i];
+        firstMoveCutoffs[i] += other.firstMoveCutoffs[i];
+        iterationNodes[i] += other.iterationNodes[i];
+    }
+    for (size_t i = 0; i < kQDepthBuckets; ++i)
+        qDepthNodes[i] += other.qDepthNodes[i];
+    cutoffMoveIndexSum += other.cutoffMoveIndexSum;
+}
+
+uint64_t SearchTreeStats::totalBetaCutoffs() const noexcept {
+    return std::accumulate(betaCutoffs.begin(), betaCutoffs.end(), uint64_t{0});
+}
+
+uint64_t SearchTreeStats::totalFirstMoveCutoffs() const noexcept {
+    return std::accumulate(firstMoveCutoffs.begin(), firstMoveCutoffs.end(), uint64_t{0});
+}
+
+double SearchTreeStats::effectiveBranchingFactor() const noexcept {
+    for (size_t depth = kDepthBuckets - 1; depth > 0; --depth) {
+        if (iterationNodes[depth] == 0)
+            continue;
+        if (iterationNodes[depth - 1] == 0)
+            return 0.0;
+        return static_cast<double>(iterationNodes[depth]) / static_cast<double>(iterationNodes[depth - 1]);
+    }
+    return 0.0;
+}
+
 SearchResult Search::search(Position& pos, const SearchLimits& limits) {
     MoveList moves(pos);
     return searchImpl_(pos, limits, std::span<const Move>(moves.begin(), moves.size()));
@@ -39,7 +73,12 @@ SearchResult Search::search(Position& pos, const SearchLimits& limits, std::span
 SearchResult Search::searchImpl_(Position& pos, const SearchLimits& limits, std::span<const Move> rootMoves) {
     nodes_ = 0;
     qNodes_ = 0;
+    nodeLimit_ = limits.nodes.value_or(0);
+    flushedNodes_ = 0;
     aborted_ = false;
+    collectTreeStats_ = limits.treeStats;
+    treeStats_ = {};
+    evalCache_.resetCounters();
     resetHeuristics_();
     pvLength_.fill(0);
     for (auto& pvLine : pvTable_) {
@@ -65,6 +104,8 @@ SearchResult Search::searchImpl_(Position& pos, const SearchLimits& limits, std:
         result.bestMove = Move{};
         result.telemetry.nodes = nodes_;
         result.telemetry.qNodes = qNodes_;
+        result.telemetry.evalCacheHits = evalCache_.hits();
+        result.telemetry.evalCacheMisses = evalCache_.misses();
         return result;
     }
 
@@ -72,6 +113,9 @@ SearchResult Search::searchImpl_(Position& pos, const SearchLimits& limits, std:
     Eval bestScore = evaluate_(pos);
     const Depth targetDepth = limits.infinite ? (kMaxPly - 1) : limits.depth;
     const Depth firstDepth = limits.iterativeDeepening ? 1 : targetDepth;
+    const size_t lineCount = std::min(static_cast<size_t>(std::max(1, limits.multiPV)), moves.size());
+    std::vector<RootLine> lines;
+    std::vector<RootLine> previousLines;
     bool softStopped = false;
 
     for (Depth currentDepth = firstDepth; currentDepth <= targetDepth; ++currentDepth) {
@@ -80,7 +124,8 @@ SearchResult Search::searchImpl_(Position& pos, const SearchLimits& limits, std:
             break;
         }
 
-        pvLength_[0] = 0;
+        const TraceScope iterationScope("iteration", "depth", currentDepth);
+        const uint64_t nodesBeforeIteration = nodes_ + qNodes_;
         Move ttMove = bestMove;
         if (tt_ != nullptr) {
             if (const auto hit = tt_->probe(pos.hash())) {
@@ -90,69 +135,49 @@ SearchResult Search::searchImpl_(Position& pos, const SearchLimits& limits, std:
             }
         }
 
-        MoveList orderedMoves;
-        for (const Move move : moves)
-            orderedMoves.push_back(move);
-        orderMoves_(pos, orderedMoves, ttMove, 0);
-        diversifyRootMoves_(orderedMoves);
-
-        Eval alpha = -kEvalInf;
-        const Eval beta = kEvalInf;
-
-        Eval iterationBestScore = -kEvalInf;
-        Move iterationBestMove{};
+        // Each further MultiPV line searches the root moves that no earlier line of this iteration starts with,
+        // led by the move of the same line in the previous iteration. Their subtrees are mostly in the TT by then.
+        lines.clear();
         bool iterationAborted = false;
-
-        for (const Move m : orderedMoves) {
-            if (shouldStopHard_()) {
-                iterationAborted = true;
-                break;
+        for (size_t pvIndex = 0; pvIndex < lineCount; ++pvIndex) {
+            MoveList orderedMoves;
+            for (const Move move : moves) {
+                if (std::ranges::none_of(lines, [move](const RootLine& line) { return line.pv[0] == move; }))
+                    orderedMoves.push_back(move);
             }
-
-            const bool irreversible = isIrreversibleMove_(pos, m);
-            UndoInfo u{};
-            pos.makeMove(m, u);
-            pushHistory_(pos, irreversible);
-
-            const Eval score = -alphaBeta_(pos, currentDepth - 1, -beta, -alpha, 1);
-
-            popHistory_();
-            pos.undoMove(m, u);
-
-            if (aborted_) {
+            Move lineMove = ttMove;
+            if (pvIndex > 0)
+                lineMove = pvIndex < previousLines.size() ? previousLines[pvIndex].pv[0] : Move::none();
+            orderMoves_(pos, orderedMoves, lineMove, 0);
+            diversifyRootMoves_(orderedMoves);
+
+            RootLine line;
+            if (!searchRootMoves_(pos, orderedMoves, currentDepth, line)) {
                 iterationAborted = true;
                 break;
             }
-
-            if (score > iterationBestScore) {
-                iterationBestScore = score;
-                iterationBestMove = m;
-
-                pvTable_[0][0] = m;
-                pvLength_[0] = 1;
-                if (kMaxPly > 1) {
-                    for (uint8_t i = 1; i < pvLength_[1] && i < kMaxPly; ++i) {
-                        pvTable_[0][i] = pvTable_[1][i];
-                        pvLength_[0] = static_cast<uint8_t>(i + 1);
-                    }
-                }
-            }
-
-            alpha = std::max(alpha, score);
+            lines.push_back(line);
         }
 
         if (iterationAborted)
             break;
 
-        bestMove = iterationBestMove;
-        bestScore = iterationBestScore;
+        if (collectTreeStats_) {
+            const size_t bucket = std::min<size_t>(currentDepth, SearchTreeStats::kDepthBuckets - 1);
+            treeStats_.iterationNodes[bucket] += nodes_ + qNodes_ - nodesBeforeIteration;
+        }
+
+        const RootLine& bestLine = lines.front();
+        bestMove = bestLine.pvLength > 0 ? bestLine.pv[0] : Move{};
+        bestScore = bestLine.score;
         result.score = bestScore;
         result.bestMove = bestMove;
         result.telemetry.completedDepth = currentDepth;
-        result.pvLength = pvLength_[0];
-        for (uint8_t i = 0; i < result.pvLength; ++i) {
-            result.pv[i] = pvTable_[0][i];
-        }
+        result.pv = bestLine.pv;
+        result.pvLength = bestLine.pvLength;
+        if (lineCount > 1)
+            result.lines = lines;
+        previousLines.swap(lines);
         if (iterationCallback_)
             iterationCallback_(result);
 
@@ -173,10 +198,57 @@ SearchResult Search::searchImpl_(Position& pos, const SearchLimits& limits, std:
 
     result.telemetry.nodes = nodes_;
     result.telemetry.qNodes = qNodes_;
+    result.telemetry.evalCacheHits = evalCache_.hits();
+    result.telemetry.evalCacheMisses = evalCache_.misses();
+    result.telemetry.treeStats = treeStats_;
     result.stopped = aborted_ || softStopped;
     return result;
 }
 
+bool Search::searchRootMoves_(Position& pos, const MoveList& orderedMoves, Depth depth, RootLine& line) {
+    pvLength_[0] = 0;
+    Eval alpha = -kEvalInf;
+    const Eval beta = kEvalInf;
+    line.score = -kEvalInf;
+
+    for (const Move m : orderedMoves) {
+        if (shouldStopHard_())
+            return false;
+
+        const bool irreversible = isIrreversibleMove_(pos, m);
+        UndoInfo u{};
+        pos.makeMove(m, u);
+        pushHistory_(pos, irreversible);
+
+        const Eval score = -alphaBeta_(pos, depth - 1, -beta, -alpha, 1);
+
+        popHistory_();
+        pos.undoMove(m, u);
+
+        if (aborted_)
+            return false;
+
+        if (score > line.score) {
+            line.score = score;
+
+            pvTable_[0][0] = m;
+            pvLength_[0] = 1;
+            if (kMaxPly > 1) {
+                for (uint8_t i = 1; i < pvLength_[1] && i < kMaxPly; ++i) {
+                    pvTable_[0][i] = pvTable_[1][i];
+                    pvLength_[0] = static_cast<uint8_t>(i + 1);
+                }
+            }
+        }
+
+        alpha = std::max(alpha, score);
+    }
+
+    line.pvLength = pvLength_[0];
+    std::copy_n(pvTable_[0].begin(), line.pvLength, line.pv.begin());
+    return true;
+}
+
 Eval Search::alphaBeta_(Position& pos, Depth depth, Eval alpha, Eval beta, int ply) {
     if (shouldStopHard_())
         return 0;
@@ -191,11 +263,8 @@ Eval Search::alphaBeta_(Position& pos, Depth depth, Eval alpha, Eval beta, int p
     if (depth <= 0)
         return quiescence_(pos, alpha, beta, ply);
 
-    MoveList moves(pos);
-
-    Eval terminalScore = 0;
-    if (isTerminal_(pos, moves, ply, terminalScore))
-        return terminalScore;
+    if (pos.halfmoveClock() >= 100 || isDrawByRepetition_(pos))
+        return kDrawScore;
 
     const Eval originalAlpha = alpha;
     const Key key = pos.hash();
@@ -230,14 +299,15 @@ Eval Search::alphaBeta_(Position& pos, Depth depth, Eval alpha, Eval beta, int p
         }
     }
 
-    orderMoves_(pos, moves, ttMove, ply);
-
     Eval bestScore = -kEvalInf;
     Move bestMove{};
+    int legalMoves = 0;
 
-    for (const Move m : moves) {
+    // Searches a legal move, returning true once the node is done because of a beta cutoff or an abort
+    const auto searchMove = [&](Move m) {
         if (shouldStopHard_())
-            return 0;
+            return true;
+        ++legalMoves;
 
         const bool irreversible = isIrreversibleMove_(pos, m);
         UndoInfo u{};
@@ -250,7 +320,7 @@ Eval Search::alphaBeta_(Position& pos, Depth depth, Eval alpha, Eval beta, int p
         pos.undoMove(m, u);
 
         if (aborted_)
-            return 0;
+            return true;
 
         if (score > bestScore) {
             bestScore = score;
@@ -271,10 +341,64 @@ Eval Search::alphaBeta_(Position& pos, Depth depth, Eval alpha, Eval beta, int p
         if (alpha >= beta) {
             if (!m.isCapture() && !m.isPromotion())
                 updateQuietHeuristics_(pos, m, ply, depth);
+            if (collectTreeStats_) {
+                const size_t bucket = std::min<size_t>(depth, SearchTreeStats::kDepthBuckets - 1);
+                ++treeStats_.betaCutoffs[bucket];
+                treeStats_.firstMoveCutoffs[bucket] += (legalMoves == 1) ? 1 : 0;
+                treeStats_.cutoffMoveIndexSum += static_cast<uint64_t>(legalMoves - 1);
+            }
+            return true;
+        }
+        return false;
+    };
+
+    // Moves are searched in stages, generating each stage only when the previous ones did not cut off: the TT move,
+    // captures and promotions, killers, then the remaining quiet moves. TT moves and killers are validated against the
+    // position, as they may come from a hash collision or a different position at the same ply.
+    const std::array<Move, 2> killers = (ply < kMaxPly) ? killers_[ply] : std::array<Move, 2>{};
+    const auto isKiller = [&](Move m) { return m == killers[0] || m == killers[1]; };
+    bool done = !ttMove.isNone() && pos.isPseudoLegal(ttMove) && pos.isLegal(ttMove) && searchMove(ttMove);
+
+    MoveList moves{};
+    if (!done) {
+        generate_pseudo_legal_moves(pos, moves, GenMode::Tactical);
+        orderMoves_(pos, moves, ttMove, ply);
+        for (const Move m : moves) {
+            if (m == ttMove || !pos.isLegal(m))
+                continue;
+            done = searchMove(m);
+            if (done)
+                break;
+        }
+    }
+
+    for (const Move killer : killers) {
+        if (done)
             break;
+        if (killer.isNone() || killer == ttMove || killer.isCapture() || killer.isPromotion())
+            continue;
+        if (pos.isPseudoLegal(killer) && pos.isLegal(killer))
+            done = searchMove(killer);
+    }
+
+    if (!done) {
+        generate_pseudo_legal_moves(pos, moves, GenMode::Quiets);
+        orderMoves_(pos, moves, ttMove, ply);
+        for (const Move m : moves) {
+            if (m == ttMove || isKiller(m) || !pos.isLegal(m))
+                continue;
+            done = searchMove(m);
+            if (done)
+                break;
         }
     }
 
+    if (aborted_)
+        return 0;
+
+    if (legalMoves == 0)
+        return pos.inCheck() ? mated_score(ply) : kDrawScore;
+
     if (tt_ != nullptr && !aborted_) {
         Bound bound = Bound::Exact;
         if (bestScore <= originalAlpha)
@@ -288,11 +412,13 @@ Eval Search::alphaBeta_(Position& pos, Depth depth, Eval alpha, Eval beta, int p
     return bestScore;
 }
 
-Eval Search::quiescence_(Position& pos, Eval alpha, Eval beta, int ply) {
+Eval Search::quiescence_(Position& pos, Eval alpha, Eval beta, int ply, int qPly) {
     if (shouldStopHard_())
         return 0;
 
     ++qNodes_;
+    if (collectTreeStats_)
+        ++treeStats_.qDepthNodes[std::min<size_t>(qPly, SearchTreeStats::kQDepthBuckets - 1)];
 
     if (ply < kMaxPly)
         pvLength_[ply] = static_cast<uint8_t>(ply);
@@ -300,13 +426,12 @@ Eval Search::quiescence_(Position& pos, Eval alpha, Eval beta, int ply) {
     if (ply >= kMaxPly)
         return evaluate_(pos);
 
+    if (pos.halfmoveClock() >= 100 || isDrawByRepetition_(pos))
+        return kDrawScore;
+
     const bool inCheck = pos.inCheck();
     MoveList moves{};
-    generate_moves(pos, moves, inCheck ? GenMode::Evasions : GenMode::Tactical);
-
-    Eval terminalScore = 0;
-    if (isTerminal_(pos, moves, ply, terminalScore))
-        return terminalScore;
+    generate_pseudo_legal_moves(pos, moves, inCheck ? GenMode::Evasions : GenMode::Tactical);
 
     Eval standPat = kEvalNegInf;
     if (!inCheck) {
@@ -319,6 +444,7 @@ Eval Search::quiescence_(Position& pos, Eval alpha, Eval beta, int ply) {
 
     orderQMoves_(pos, moves, inCheck);
 
+    int legalMoves = 0;
     for (const Move m : moves) {
         if (shouldStopHard_())
             return 0;
@@ -332,12 +458,17 @@ Eval Search::quiescence_(Position& pos, Eval alpha, Eval beta, int ply) {
                 continue;
         }
 
+        // Checked after the pruning above, as it is only needed for the moves actually made
+        if (!pos.isLegal(m))
+            continue;
+        ++legalMoves;
+
         const bool irreversible = isIrreversibleMove_(pos, m);
         UndoInfo u{};
         pos.makeMove(m, u);
         pushHistory_(pos, irreversible);
 
-        const Eval score = -quiescence_(pos, -beta, -alpha, ply + 1);
+        const Eval score = -quiescence_(pos, -beta, -alpha, ply + 1, qPly + 1);
 
         popHistory_();
         pos.undoMove(m, u);
@@ -370,11 +501,24 @@ Eval Search::quiescence_(Position& pos, Eval alpha, Eval beta, int ply) {
         }
     }
 
+    // Evasions are all the moves in check, so having no legal one is checkmate. An empty tactical move list does not
+    // imply stalemate, so it is not terminal
+    if (inCheck && legalMoves == 0)
+        return mated_score(ply);
+
     return alpha;
 }
 
 Eval Search::evaluate_(const Position& pos) noexcept {
-    const Eval score = evaluation(pos);
+    const Key key = pos.hash();
+    Eval score = 0;
+    if (const auto cached = evalCache_.probe(key)) {
+        score = *cached;
+    }
+    else {
+        score = evaluation(pos);
+        evalCache_.store(key, score);
+    }
     return (pos.sideToMove() == Color::White) ? score : -score;
 }
 
@@ -452,6 +596,12 @@ bool Search::shouldStopHard_() noexcept {
     if (aborted_)
         return true;
 
+    // Exact for a single worker, so fixed-node searches are reproducible
+    if (nodeLimit_ != 0 && nodes_ + qNodes_ >= nodeLimit_) {
+        aborted_ = true;
+        return true;
+    }
+
     if (sharedState_ == nullptr)
         return false;
 
@@ -460,9 +610,22 @@ bool Search::shouldStopHard_() noexcept {
     if (totalNodes != 0 && totalNodes % 1024 != 0)
         return false;
 
+    // With several workers the limit applies to their sum, overshooting by at most 1024 nodes per worker
+    if (nodeLimit_ != 0) {
+        const uint64_t unflushed = totalNodes - flushedNodes_;
+        flushedNodes_ = totalNodes;
+        const uint64_t searched =
+            sharedState_->nodesSearched.fetch_add(unflushed, std::memory_order_relaxed) + unflushed;
+        if (searched >= nodeLimit_) {
+            aborted_ = true;
+            return true;
+        }
+    }
+
     const bool stopRequested = sharedState_->stopRequested.load(std::memory_order_relaxed);
-    const bool deadlineReached =
-        sharedState_->hardDeadline.has_value() && std::chrono::steady_clock::now() >= *sharedState_->hardDeadline;
+    const bool deadlineReached = sharedState_->hardDeadline.has_value() &&
+        !sharedState_->pondering.load(std::memory_order_relaxed) &&
+        std::chrono::steady_clock::now() >= *sharedState_->hardDeadline;
 
     aborted_ = stopRequested || deadlineReached;
     return aborted_;
@@ -471,6 +634,8 @@ bool Search::shouldStopHard_() noexcept {
 bool Search::shouldStopSoft_() const noexcept {
     if (sharedState_ == nullptr || !sharedState_->softDeadline.has_value())
         return false;
+    if (sharedState_->pondering.load(std::memory_order_relaxed))
+        return false;
 
     return std::chrono::steady_clock::now() >= *sharedState_->softDeadline;
 }
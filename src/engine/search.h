@@ -8,6 +8,7 @@
 #include <span>
 #include <vector>
 
+#include "eval_cache.h"
 #include "eval_constants.h"
 #include "move_gen/generator.h"
 #include "position.h"
@@ -27,6 +28,7 @@ struct SearchLimits {
     bool infinite{false};
     bool iterativeDeepening{true};
     std::optional<std::chrono::milliseconds> moveTime{};
+    std::optional<uint64_t> nodes{};  // Stop after this many nodes (regular + quiescence), summed over all threads
 
     struct TimeControl {
         std::optional<std::chrono::milliseconds> whiteTime;
@@ -37,17 +39,48 @@ struct SearchLimits {
     };
 
     std::optional<TimeControl> timeControl{};
+    bool treeStats{false};  // Gather `SearchTreeStats` (move ordering and tree shape counters)
+    int multiPV{1};         // Number of best root moves to search exactly, each with its own score and PV
+};
+
+// Move ordering and tree shape counters, only gathered when `SearchLimits::treeStats` is set.
+// Depth-indexed arrays clamp larger depths into their last bucket.
+struct SearchTreeStats {
+    static constexpr size_t kDepthBuckets = 64;
+    static constexpr size_t kQDepthBuckets = 16;
+
+    std::array<uint64_t, kDepthBuckets> betaCutoffs{};       // Main search fail-highs, by remaining depth
+    std::array<uint64_t, kDepthBuckets> firstMoveCutoffs{};  // Fail-highs on the first legal move, by remaining depth
+    uint64_t cutoffMoveIndexSum{};                           // Sum of the 0-based legal move index of each fail-high
+    std::array<uint64_t, kQDepthBuckets> qDepthNodes{};      // Quiescence nodes, by plies below the main search horizon
+    std::array<uint64_t, kDepthBuckets> iterationNodes{};    // Nodes (regular + quiescence) spent on each iteration
+
+    void merge(const SearchTreeStats& other) noexcept;
+    uint64_t totalBetaCutoffs() const noexcept;
+    uint64_t totalFirstMoveCutoffs() const noexcept;
+    // Ratio of the nodes spent on the deepest iteration to the previous one, or 0 with fewer than two iterations.
+    double effectiveBranchingFactor() const noexcept;
 };
 
 struct SearchTelemetry {
-    uint64_t nodes{};           // Number of regular search nodes searched
-    uint64_t qNodes{};          // Number of quiescence nodes searched
-    uint64_t elapsedMs{};       // Wall-clock time for the completed search
-    uint64_t ttHits{};          // TT probe hits across all workers
-    uint64_t ttMisses{};        // TT probe misses across all workers
-    uint64_t ttWrites{};        // TT writes into empty slots
-    uint64_t ttRewrites{};      // TT rewrites of existing slots
-    Depth completedDepth{};     // Deepest fully completed iterative deepening iteration
+    uint64_t nodes{};             // Number of regular search nodes searched
+    uint64_t qNodes{};            // Number of quiescence nodes searched
+    uint64_t elapsedMs{};         // Wall-clock time for the completed search
+    uint64_t ttHits{};            // TT probe hits across all workers
+    uint64_t ttMisses{};          // TT probe misses across all workers
+    uint64_t ttWrites{};          // TT writes into empty slots
+    uint64_t ttRewrites{};        // TT rewrites of existing slots
+    uint64_t evalCacheHits{};     // Eval cache probe hits across all workers
+    uint64_t evalCacheMisses{};   // Eval cache probe misses across all workers
+    Depth completedDepth{};       // Deepest fully completed iterative deepening iteration
+    SearchTreeStats treeStats{};  // Empty unless `SearchLimits::treeStats` was set
+};
+
+// The line below one root move, as searched with a full window.
+struct RootLine {
+    Eval score{};                    // Relative evaluation of the root move
+    std::array<Move, kMaxPly> pv{};  // Principal variation, starting with the root move
+    uint8_t pvLength{};              // Number of moves in `pv`
 };
 
 struct SearchResult {
@@ -57,6 +90,7 @@ struct SearchResult {
     uint8_t pvLength{};              // Number of moves in `pv`
     bool stopped{};                  // Whether the search stopped before reaching its target depth
     SearchTelemetry telemetry{};     // Search counters and timing info for this completed search
+    std::vector<RootLine> lines{};   // Best first, the first matching `pv`. Empty unless `SearchLimits::multiPV` > 1
 };
 
 using SearchIterationCallback = std::function<void(const SearchResult&)>;
@@ -65,6 +99,8 @@ struct SearchSharedState {
     std::atomic<bool> stopRequested{false};
     std::optional<std::chrono::steady_clock::time_point> softDeadline;
     std::optional<std::chrono::steady_clock::time_point> hardDeadline;
+    std::atomic<uint64_t> nodesSearched{0};  // Nodes of all workers, flushed periodically for `SearchLimits::nodes`
+    std::atomic<bool> pondering{false};      // The deadlines are ignored until cleared on `ponderhit`
 };
 
 class Search {
@@ -81,12 +117,16 @@ public:
     SearchResult search(Position& pos, const SearchLimits& limits);
     SearchResult search(Position& pos, const SearchLimits& limits, std::span<const Move> rootMoves);
     void setIterationCallback(SearchIterationCallback callback) { iterationCallback_ = std::move(callback); }
+    // Replaces the hashes of the positions played up to and including the next search root, for repetition detection.
+    void setPositionHistory(std::vector<Key> history) { positionHistory_ = std::move(history); }
 
 private:
     SearchResult searchImpl_(Position& pos, const SearchLimits& limits, std::span<const Move> rootMoves);
+    // Searches the ordered root moves with a full window, returning false if the search was aborted.
+    bool searchRootMoves_(Position& pos, const MoveList& orderedMoves, Depth depth, RootLine& line);
     Eval alphaBeta_(Position& pos, Depth depth, Eval alpha, Eval beta, int ply);
-    Eval quiescence_(Position& pos, Eval alpha, Eval beta, int ply);
-    static Eval evaluate_(const Position& pos) noexcept;
+    Eval quiescence_(Position& pos, Eval alpha, Eval beta, int ply, int qPly = 0);
+    Eval evaluate_(const Position& pos) noexcept;
     bool isTerminal_(const Position& pos, const MoveList& moves, int ply, Eval& terminalScore) const noexcept;
     void resetHeuristics_() noexcept;
     void orderMoves_(const Position& pos, MoveList& moves, Move ttMove, int ply) const noexcept;
@@ -110,7 +150,14 @@ private:
     int workerId_{};
     uint64_t nodes_{};
     uint64_t qNodes_{};
+    uint64_t nodeLimit_{};     // 0 = no node limit
+    uint64_t flushedNodes_{};  // Nodes already added to `SearchSharedState::nodesSearched`
     bool aborted_{false};
+    bool collectTreeStats_{false};
+    SearchTreeStats treeStats_{};
+
+    // Per-thread cache of static evaluations, consulted before calling `evaluation()`
+    EvalCache evalCache_{};
 
     // Principal variation table updated during search
     std::array<std::array<Move, kMaxPly>, kMaxPly> pvTable_{};
@@ -0,0 +1,230 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace engine {
+
+namespace {
+
+enum class TracePhase : char {
+    Complete = 'X',
+    Instant = 'i',
+};
+
+struct TraceEvent {
+    const char* name;
+    const char* argName;  // Null without an argument
+    int64_t arg;
+    int64_t startNs;  // Steady clock time
+    int64_t durationNs;
+    uint32_t threadId;
+    TracePhase phase;
+};
+
+// Single producer ring of events. A buffer outlives its thread and is handed to the next new thread, so spawning
+// workers for every search does not grow the registry; the events keep the id of the thread that recorded them.
+struct TraceBuffer {
+    static constexpr uint64_t kCapacity = 8192;
+
+    std::array<TraceEvent, kCapacity> events{};
+    std::atomic<uint64_t> written{0};  // Total events recorded, the next slot is `written % kCapacity`
+    uint32_t ownerThreadId{0};         // 0 while free, guarded by the registry mutex
+};
+
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    std::vector<std::pair<uint32_t, std::string>> threadNames;
+    uint32_t nextThreadId{1};
+    int64_t epochNs{0};  // Steady clock time the exported timestamps are relative to
+};
+
+TraceRegistry& registry() {
+    static TraceRegistry instance;
+    return instance;
+}
+
+int64_t now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct ThreadTraceState {
+    TraceBuffer* buffer{nullptr};
+    uint32_t threadId{0};
+
+    ThreadTraceState() = default;
+    ThreadTraceState(const ThreadTraceState&) = delete;
+    ThreadTraceState& operator=(const ThreadTraceState&) = delete;
+
+    ~ThreadTraceState() {
+        if (buffer == nullptr)
+            return;
+        TraceRegistry& reg = registry();
+        const std::scoped_lock lock(reg.mutex);
+        buffer->ownerThreadId = 0;
+    }
+};
+
+thread_local ThreadTraceState tThreadState;
+
+// Claims a free buffer (or allocates one) on the first event of the calling thread.
+ThreadTraceState& thread_state() {
+    if (tThreadState.buffer != nullptr)
+        return tThreadState;
+
+    TraceRegistry& reg = registry();
+    const std::scoped_lock lock(reg.mutex);
+    const auto it = std::ranges::find(reg.buffers, 0U, [](const auto& buffer) { return buffer->ownerThreadId; });
+    if (it != reg.buffers.end()) {
+        tThreadState.buffer = it->get();
+    }
+    else {
+        reg.buffers.push_back(std::make_unique<TraceBuffer>());
+        tThreadState.buffer = reg.buffers.back().get();
+    }
+    tThreadState.threadId = reg.nextThreadId++;
+    tThreadState.buffer->ownerThreadId = tThreadState.threadId;
+    return tThreadState;
+}
+
+void record(TracePhase phase, const char* name, const char* argName, int64_t arg, int64_t startNs, int64_t durationNs) {
+    ThreadTraceState& state = thread_state();
+    TraceBuffer& buffer = *state.buffer;
+    const uint64_t n = buffer.written.load(std::memory_order_relaxed);
+    buffer.events[n % TraceBuffer::kCapacity] = TraceEvent{
+        .name = name,
+        .argName = argName,
+        .arg = arg,
+        .startNs = startNs,
+        .durationNs = durationNs,
+        .threadId = state.threadId,
+        .phase = phase,
+    };
+    buffer.written.store(n + 1, std::memory_order_release);
+}
+
+std::string json_escape(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (const char c : text) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            out += c;
+    }
+    return out;
+}
+
+std::string format_us(int64_t ns) {
+    return std::format("{:.3f}", static_cast<double>(ns) / 1000.0);
+}
+
+}  // namespace
+
+void set_tracing(bool enabled) noexcept {
+    if (enabled && !tracing_enabled()) {
+        TraceRegistry& reg = registry();
+        const std::scoped_lock lock(reg.mutex);
+        reg.epochNs = now_ns();
+    }
+    detail::gTracingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void clear_trace() noexcept {
+    TraceRegistry& reg = registry();
+    const std::scoped_lock lock(reg.mutex);
+    for (const auto& buffer : reg.buffers)
+        buffer->written.store(0, std::memory_order_relaxed);
+
+    // Keep the names of live threads only, their events are gone
+    std::erase_if(reg.threadNames, [&](const auto& entry) {
+        return std::ranges::none_of(reg.buffers, [&](const auto& buffer) {
+            return buffer->ownerThreadId == entry.first;
+        });
+    });
+    reg.epochNs = now_ns();
+}
+
+void set_trace_thread_name(std::string_view name) {
+    if (!tracing_enabled())
+        return;
+
+    const uint32_t threadId = thread_state().threadId;
+    TraceRegistry& reg = registry();
+    const std::scoped_lock lock(reg.mutex);
+    const auto it = std::ranges::find(reg.threadNames, threadId, &std::pair<uint32_t, std::string>::first);
+    if (it != reg.threadNames.end())
+        it->second = name;
+    else
+        reg.threadNames.emplace_back(threadId, std::string(name));
+}
+
+void trace_instant(const char* name, const char* argName, int64_t arg) noexcept {
+    if (!tracing_enabled())
+        return;
+    record(TracePhase::Instant, name, argName, arg, now_ns(), 0);
+}
+
+TraceScope::~TraceScope() {
+    if (start_ == std::chrono::steady_clock::time_point{} || !tracing_enabled())
+        return;
+
+    const int64_t startNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(start_.time_since_epoch()).count();
+    record(TracePhase::Complete, name_, argName_, arg_, startNs, now_ns() - startNs);
+}
+
+void write_chrome_trace(std::ostream& out) {
+    TraceRegistry& reg = registry();
+    const std::scoped_lock lock(reg.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << R"({"ph":"M","pid":1,"tid":0,"name":"process_name","args":{"name":"parfait"}})";
+    for (const auto& [threadId, name] : reg.threadNames) {
+        out << std::format(
+            ",\n{{\"ph\":\"M\",\"pid\":1,\"tid\":{},\"name\":\"thread_name\",\"args\":{{\"name\":\"{}\"}}}}",
+            threadId,
+            json_escape(name)
+        );
+        // Order the threads in the viewer by id, which follows spawn order
+        out << std::format(
+            ",\n{{\"ph\":\"M\",\"pid\":1,\"tid\":{},\"name\":\"thread_sort_index\",\"args\":{{\"sort_index\":{}}}}}",
+            threadId,
+            threadId
+        );
+    }
+
+    for (const auto& buffer : reg.buffers) {
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const uint64_t first = written > TraceBuffer::kCapacity ? written - TraceBuffer::kCapacity : 0;
+        for (uint64_t i = first; i < written; ++i) {
+            const TraceEvent& event = buffer->events[i % TraceBuffer::kCapacity];
+            out << std::format(
+                ",\n{{\"ph\":\"{}\",\"pid\":1,\"tid\":{},\"name\":\"{}\",\"ts\":{}",
+                static_cast<char>(event.phase),
+                event.threadId,
+                json_escape(event.name),
+                format_us(event.startNs - reg.epochNs)
+            );
+            if (event.phase == TracePhase::Complete)
+                out << ",\"dur\":" << format_us(event.durationNs);
+            else
+                out << ",\"s\":\"t\"";
+            if (event.argName != nullptr)
+                out << std::format(",\"args\":{{\"{}\":{}}}", json_escape(event.argName), event.arg);
+            out << '}';
+        }
+    }
+    out << "\n]}\n";
+}
+
+}  // namespace engine
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+namespace engine {
+
+namespace detail {
+inline std::atomic<bool> gTracingEnabled{false};
+}  // namespace detail
+
+// Timeline tracing of the search threads, exported in the Chrome trace event format (chrome://tracing, Perfetto).
+// Every thread appends to its own fixed-size ring buffer without locking, so the oldest events of a thread are
+// overwritten once it wraps. Recording costs one relaxed load while tracing is disabled.
+// Event names and argument names must be string literals, as only the pointers are stored.
+
+inline bool tracing_enabled() noexcept {
+    return detail::gTracingEnabled.load(std::memory_order_relaxed);
+}
+
+void set_tracing(bool enabled) noexcept;
+
+// Drops the recorded events. Must not race with threads that are recording.
+void clear_trace() noexcept;
+
+// Labels the calling thread in the exported timeline. Only takes effect while tracing is enabled.
+void set_trace_thread_name(std::string_view name);
+
+// Records a zero-duration event on the calling thread.
+void trace_instant(const char* name, const char* argName = nullptr, int64_t arg = 0) noexcept;
+
+// Writes the recorded events as a Chrome trace JSON document. Must not race with threads that are recording, so call
+// it once the traced search has been joined.
+void write_chrome_trace(std::ostream& out);
+
+// Records the lifetime of the scope as one complete event on the constructing thread.
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, const char* argName = nullptr, int64_t arg = 0) noexcept
+        : name_(name), argName_(argName), arg_(arg) {
+        if (tracing_enabled())
+            start_ = std::chrono::steady_clock::now();
+    }
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    TraceScope(TraceScope&&) = delete;
+    TraceScope& operator=(TraceScope&&) = delete;
+
+private:
+    const char* name_;
+    const char* argName_;
+    int64_t arg_;
+    std::chrono::steady_clock::time_point start_{};  // Epoch when tracing was off at construction
+};
+
+}  // namespace engine
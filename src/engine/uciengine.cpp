@@ -1,6 +1,7 @@
 #include "uciengine.h"
 
 #include <algorithm>
+#include <array>
 #include <optional>
 #include <ranges>
 #include <sstream>
@@ -18,11 +19,23 @@ struct ParsedSetOption {
 
 struct ParsedGo {
     std::optional<Depth> depth;
+    std::optional<Depth> perft;
     bool infinite{false};
     std::optional<std::chrono::milliseconds> moveTime;
     std::optional<SearchLimits::TimeControl> timeControl;
+    std::optional<uint64_t> nodes;
+    bool ponder{false};
+    std::vector<std::string> searchMoves;
 };
 
+bool isGoKeyword(std::string_view token) noexcept {
+    constexpr std::array<std::string_view, 13> kKeywords = {
+        "searchmoves", "ponder", "wtime", "btime", "winc", "binc", "movestogo",
+        "depth", "nodes", "mate", "movetime", "infinite", "perft",
+    };
+    return std::ranges::find(kKeywords, token) != kKeywords.end();
+}
+
 std::optional<ParsedSetOption> parseSetOption(std::istringstream& iss) {
     std::string token;
     if (!(iss >> token) || token != "name")
@@ -55,12 +68,28 @@ ParsedGo parseGo(std::istringstream& iss) {
     bool hasTimeControl = false;
 
     std::string token;
+    bool readingSearchMoves = false;
     while (iss >> token) {
-        if (token == "depth") {
+        // The moves after `searchmoves` run up to the next keyword
+        if (readingSearchMoves && !isGoKeyword(token)) {
+            parsed.searchMoves.push_back(token);
+            continue;
+        }
+        readingSearchMoves = false;
+
+        if (token == "searchmoves") {
+            readingSearchMoves = true;
+        }
+        else if (token == "depth") {
             Depth depth = 0;
             if (iss >> depth)
                 parsed.depth = depth;
         }
+        else if (token == "perft") {
+            Depth depth = 0;
+            if (iss >> depth)
+                parsed.perft = depth;
+        }
         else if (token == "movetime") {
             int moveTimeMs = 0;
             if (iss >> moveTimeMs)
@@ -101,9 +130,17 @@ ParsedGo parseGo(std::istringstream& iss) {
                 hasTimeControl = true;
             }
         }
+        else if (token == "nodes") {
+            uint64_t nodes = 0;
+            if (iss >> nodes && nodes > 0)
+                parsed.nodes = nodes;
+        }
         else if (token == "infinite") {
             parsed.infinite = true;
         }
+        else if (token == "ponder") {
+            parsed.ponder = true;
+        }
     }
 
     if (hasTimeControl)
@@ -184,7 +221,30 @@ void UCIEngine::loop() {
         }
         else if (command == "go") {
             const ParsedGo go = parseGo(iss);
-            engine_.startSearch_(go.depth, go.infinite, go.moveTime, go.timeControl);
+            if (go.perft.has_value()) {
+                engine_.runPerft_(*go.perft);
+                continue;
+            }
+
+            std::vector<Move> searchMoves;
+            const MoveList legalMoves(engine_.position_);
+            for (const std::string& uciMove : go.searchMoves) {
+                const auto* it = std::ranges::find_if(legalMoves, [&](Move m) { return to_string(m) == uciMove; });
+                if (it == legalMoves.end()) {
+                    std::cout << "info string Invalid move in go searchmoves: " << uciMove << '\n';
+                    std::cout.flush();
+                }
+                else if (std::ranges::find(searchMoves, *it) == searchMoves.end()) {
+                    searchMoves.push_back(*it);
+                }
+            }
+
+            engine_.startSearch_(
+                go.depth, go.infinite, go.moveTime, go.timeControl, go.nodes, go.ponder, std::move(searchMoves)
+            );
+        }
+        else if (command == "ponderhit") {
+            engine_.ponderHit_();
         }
         else if (command == "stop") {
             engine_.stopSearch_();
@@ -178,6 +178,34 @@ constexpr int bit_count(Bitboard b) noexcept {
     return __builtin_popcountll(b);
 }
 
+constexpr bool more_than_one(Bitboard b) noexcept {
+    return (b & (b - 1)) != 0;
+}
+
+// Shifts every square of the bitboard one step in the given direction, dropping squares that leave the board.
+template <Direction D>
+constexpr Bitboard shift(Bitboard b) noexcept {
+    constexpr Bitboard notFileA = ~bitboard(File::A);
+    constexpr Bitboard notFileH = ~bitboard(File::H);
+    if constexpr (D == Direction::North)
+        return b << 8;
+    if constexpr (D == Direction::South)
+        return b >> 8;
+    if constexpr (D == Direction::East)
+        return (b & notFileH) << 1;
+    if constexpr (D == Direction::West)
+        return (b & notFileA) >> 1;
+    if constexpr (D == Direction::NorthEast)
+        return (b & notFileH) << 9;
+    if constexpr (D == Direction::NorthWest)
+        return (b & notFileA) << 7;
+    if constexpr (D == Direction::SouthEast)
+        return (b & notFileH) >> 7;
+    if constexpr (D == Direction::SouthWest)
+        return (b & notFileA) >> 9;
+    return Bitboard{0};
+}
+
 // String utils
 
 inline void left_trim(std::string& s) {
@@ -4,6 +4,7 @@ function formatNumber(value) {
 
 export default function AnalysisPanel({ analysis, engineStatus, sideToMove }) {
   const pvText = analysis.pv?.length ? analysis.pv.join(" ") : "--";
+  const alternativeLines = (analysis.lines ?? []).slice(1).filter(Boolean);
 
   return (
     <aside className="analysis-column">
@@ -19,6 +20,19 @@ export default function AnalysisPanel({ analysis, engineStatus, sideToMove }) {
         <p className="subtle-text">Best move: {analysis.bestMove ?? "--"}</p>
       </div>
 
+      {alternativeLines.length > 0 && (
+        <div className="panel-card">
+          <p className="panel-title">Alternative Lines</p>
+          <ol className="multipv-list" start={2}>
+            {alternativeLines.map((line, index) => (
+              <li key={index} className="multipv-line">
+                <strong>{line.evaluation ?? "--"}</strong> {line.pv?.length ? line.pv.join(" ") : "--"}
+              </li>
+            ))}
+          </ol>
+        </div>
+      )}
+
       <div className="panel-card">
         <p className="panel-title">Search Statistics</p>
         <div className="stats-grid">
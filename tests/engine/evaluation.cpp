@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cctype>
+#include <cstdint>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine.h"
+#include "eval_cache.h"
+#include "evaluation.h"
+#include "position.h"
+
+namespace {
+
+// clang-format off
+const std::vector<const char*> kEvalFens = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "6k1/5ppp/8/6NQ/8/8/5PPP/6K1 w - - 0 1",
+};
+// clang-format on
+
+// Returns the FEN of the position with the board flipped vertically and the colors swapped.
+std::string mirror_fen(std::string_view fen) {
+    std::vector<std::string> fields;
+    for (const auto field : fen | std::views::split(' '))
+        fields.emplace_back(field.begin(), field.end());
+
+    std::vector<std::string> ranks;
+    for (const auto rank : fields[0] | std::views::split('/'))
+        ranks.emplace_back(rank.begin(), rank.end());
+
+    const auto swap_case = [](char ch) {
+        return static_cast<char>(std::isupper(ch) ? std::tolower(ch) : std::toupper(ch));
+    };
+
+    std::string board;
+    for (auto& rank : ranks | std::views::reverse) {
+        std::ranges::transform(rank, rank.begin(), swap_case);
+        if (!board.empty())
+            board += '/';
+        board += rank;
+    }
+
+    std::string castling = fields[2];
+    if (castling != "-")
+        std::ranges::transform(castling, castling.begin(), swap_case);
+
+    std::string enPassant = fields[3];
+    if (enPassant != "-")
+        enPassant[1] = static_cast<char>('1' + ('8' - enPassant[1]));
+
+    return board + (fields[1] == "w" ? " b " : " w ") + castling + ' ' + enPassant + " 0 1";
+}
+
+}  // namespace
+
+// Tests that every evaluation term is color-symmetric: mirroring the board must negate the score.
+TEST_CASE("Evaluation Symmetry", "[eval]") {
+    engine::init_engine();
+
+    for (const char* fen : kEvalFens) {
+        const Position pos = Position::fromFEN(fen);
+        const Position mirrored = Position::fromFEN(mirror_fen(fen));
+        const AttackMaps maps = compute_attack_maps(pos);
+        const AttackMaps mirroredMaps = compute_attack_maps(mirrored);
+
+        INFO(fen);
+        CHECK(mobility_diff(maps) == -mobility_diff(mirroredMaps));
+        CHECK(king_safety_diff(pos, maps) == -king_safety_diff(mirrored, mirroredMaps));
+        CHECK(threats_diff(pos, maps) == -threats_diff(mirrored, mirroredMaps));
+        CHECK(evaluation(pos) == -evaluation(mirrored));
+    }
+}
+
+TEST_CASE("Evaluation Attack Terms", "[eval]") {
+    engine::init_engine();
+
+    SECTION("Quiet start position has no king danger or threats") {
+        const Position pos = Position::fromFEN(engine::startpos);
+        const AttackMaps maps = compute_attack_maps(pos);
+
+        CHECK(king_safety_diff(pos, maps) == 0);
+        CHECK(threats_diff(pos, maps) == 0);
+    }
+
+    SECTION("Undefended knight attacked by a pawn") {
+        const Position pos = Position::fromFEN("4k3/8/8/3n4/4P3/8/8/4K3 w - - 0 1");
+        const AttackMaps maps = compute_attack_maps(pos);
+
+        CHECK(threats<Color::White>(pos, maps) == kThreatByPawnBonus + kHangingPieceBonus);
+        CHECK(threats<Color::Black>(pos, maps) == 0);
+    }
+
+    SECTION("Queen and knight attacking a castled king") {
+        const Position pos = Position::fromFEN("6k1/5ppp/8/6NQ/8/8/5PPP/6K1 w - - 0 1");
+        const AttackMaps maps = compute_attack_maps(pos);
+
+        CHECK(maps.kingAttackers[to_underlying(Color::White)] == 2);
+        CHECK(king_danger<Color::White>(pos, maps) > 0);
+        CHECK(king_danger<Color::Black>(pos, maps) == 0);
+    }
+}
+
+TEST_CASE("Evaluation Cache", "[eval][cache]") {
+    EvalCache cache(1024);
+    const Key key = 0x9E3779B97F4A7C15ULL;
+
+    SECTION("Stored scores round trip") {
+        CHECK_FALSE(cache.probe(key).has_value());
+
+        cache.store(key, 123);
+        REQUIRE(cache.probe(key).has_value());
+        CHECK(*cache.probe(key) == 123);
+    }
+
+    SECTION("Negative scores keep their sign") {
+        cache.store(key, -321);
+        REQUIRE(cache.probe(key).has_value());
+        CHECK(*cache.probe(key) == -321);
+
+        cache.store(key, INT16_MIN);
+        CHECK(*cache.probe(key) == INT16_MIN);
+    }
+
+    SECTION("Keys sharing a slot but differing in the upper bits miss") {
+        cache.store(key, 42);
+
+        CHECK_FALSE(cache.probe(key ^ (1ULL << 63)).has_value());
+        CHECK_FALSE(cache.probe(key ^ (1ULL << 16)).has_value());
+        CHECK(*cache.probe(key) == 42);
+    }
+
+    SECTION("Counters track hits and misses") {
+        cache.store(key, 7);
+        (void)cache.probe(key);
+        (void)cache.probe(key + 1);
+
+        CHECK(cache.hits() == 1);
+        CHECK(cache.misses() == 1);
+
+        cache.clear();
+        CHECK(cache.hits() == 0);
+        CHECK(cache.misses() == 0);
+        CHECK_FALSE(cache.probe(key).has_value());
+    }
+}
+
+// Measures the cost of the static evaluation and of its shared attack map stage.
+// Hidden by default; run with: `./build/evaluation_tests "[benchmark]"`
+TEST_CASE("Evaluation Benchmark", "[.][benchmark][eval]") {
+    engine::init_engine();
+
+    std::vector<Position> positions;
+    for (const char* fen : kEvalFens)
+        positions.push_back(Position::fromFEN(fen));
+
+    BENCHMARK("compute_attack_maps") {
+        Bitboard sink = 0;
+        for (const Position& pos : positions)
+            sink ^= compute_attack_maps(pos).all[to_underlying(Color::White)];
+        return sink;
+    };
+
+    BENCHMARK("evaluation") {
+        Eval sink = 0;
+        for (const Position& pos : positions)
+            sink += evaluation(pos);
+        return sink;
+    };
+}
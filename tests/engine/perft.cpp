@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
@@ -9,26 +10,28 @@
 
 #include "engine.h"
 #include "move_gen/generator.h"
+#include "perft.h"
 #include "position.h"
 #include "search.h"
 
 namespace {
 
 // NOLINTBEGIN(misc-no-recursion)
-uint64_t perft(Position& pos, Depth depth) {
+// Same as `engine::perft`, but generates pseudo-legal moves and filters them with `Position::isLegal`, like the search.
+uint64_t perft_pseudo_legal(Position& pos, Depth depth) {
     if (depth <= 0)
         return 1;
 
-    const MoveList moves(pos);
-
-    if (depth == 1)
-        return static_cast<uint64_t>(moves.size());
+    MoveList moves;
+    generate_pseudo_legal_moves(pos, moves);
 
     uint64_t nodes = 0;
     for (const Move m : moves) {
+        if (!pos.isLegal(m))
+            continue;
         UndoInfo u{};
         pos.makeMove(m, u);
-        nodes += perft(pos, depth - 1);
+        nodes += perft_pseudo_legal(pos, depth - 1);
         pos.undoMove(m, u);
     }
 
@@ -45,7 +48,7 @@ uint64_t divide(Position& pos, Depth depth) {
     for (const Move m : moves) {
         UndoInfo u{};
         pos.makeMove(m, u);
-        const uint64_t n = perft(pos, depth - 1);
+        const uint64_t n = engine::perft(pos, depth - 1);
         pos.undoMove(m, u);
 
         std::cout << to_string(m) << ": " << n << "\n";
@@ -56,6 +59,17 @@ uint64_t divide(Position& pos, Depth depth) {
     return nodes;
 }
 
+// The check info maintained by makeMove/undoMove must match a fresh computation from the same position.
+void require_fresh_check_info(const Position& pos) {
+    const Position fresh = Position::fromFEN(pos.toFEN());
+    REQUIRE(pos.checkers() == fresh.checkers());
+    REQUIRE(pos.pinned() == fresh.pinned());
+    for (const PieceType pt :
+         {PieceType::Pawn, PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen, PieceType::King}) {
+        REQUIRE(pos.checkSquares(pt) == fresh.checkSquares(pt));
+    }
+}
+
 void state_invariants(Position& pos, Depth depth) {
     if (depth <= 0)
         return;
@@ -70,12 +84,46 @@ void state_invariants(Position& pos, Depth depth) {
         pos.makeMove(m, u);
 
         REQUIRE(pos.hash() == pos.computeHash());
+        require_fresh_check_info(pos);
 
         state_invariants(pos, depth - 1);
         pos.undoMove(m, u);
 
         REQUIRE(pos.hash() == previousHash);
         REQUIRE(pos.toFEN() == previousFEN);
+        require_fresh_check_info(pos);
+    }
+}
+
+// Checks `isPseudoLegal` against the pseudo-legal generator for every possible 16-bit move encoding.
+void pseudo_legality_invariants(Position& pos, Depth depth) {
+    if (depth <= 0)
+        return;
+
+    MoveList pseudoMoves;
+    generate_pseudo_legal_moves(pos, pseudoMoves);
+    std::vector<bool> generated(1 << 16, false);
+    for (const Move m : pseudoMoves)
+        generated[m.data()] = true;
+
+    size_t mismatches = 0;
+    Move firstMismatch{};
+    for (uint32_t data = 0; data < (1 << 16); ++data) {
+        const Move m{static_cast<uint16_t>(data)};
+        if (pos.isPseudoLegal(m) != generated[data] && mismatches++ == 0)
+            firstMismatch = m;
+    }
+    INFO(pos.toFEN() << " first mismatch: " << to_string(firstMismatch) << " ("
+                     << static_cast<int>(to_underlying(firstMismatch.moveType())) << ")");
+    CHECK(mismatches == 0);
+
+    for (const Move m : pseudoMoves) {
+        if (!pos.isLegal(m))
+            continue;
+        UndoInfo u{};
+        pos.makeMove(m, u);
+        pseudo_legality_invariants(pos, depth - 1);
+        pos.undoMove(m, u);
     }
 }
 
@@ -85,36 +133,56 @@ void movegen_mode_invariants(Position& pos, Depth depth) {  // NOLINT(readabilit
 
     const MoveList legalMoves(pos, GenMode::Legal);
     const MoveList tacticalMoves(pos, GenMode::Tactical);
-    const bool inCheck = pos.inCheck();
+    const MoveList quietMoves(pos, GenMode::Quiets);
+    const MoveList quietChecks(pos, GenMode::QuietChecks);
+
+    // Filtering pseudo-legal moves with `isLegal` gives back exactly the legal moves, in every mode
+    for (const GenMode mode :
+         {GenMode::Legal, GenMode::Tactical, GenMode::Evasions, GenMode::Quiets, GenMode::QuietChecks}) {
+        const MoveList modeMoves(pos, mode);
+        MoveList pseudoMoves;
+        generate_pseudo_legal_moves(pos, pseudoMoves, mode);
+
+        size_t legalCount = 0;
+        for (const Move m : pseudoMoves) {
+            const bool legal = pos.isLegal(m);
+            CHECK(modeMoves.contains(m) == legal);
+            legalCount += legal ? 1 : 0;
+        }
+        CHECK(legalCount == modeMoves.size());
+    }
 
-    if (inCheck) {
+    if (pos.inCheck()) {
         const MoveList evasions(pos, GenMode::Evasions);
 
         REQUIRE(legalMoves.size() == evasions.size());
-        REQUIRE(legalMoves.size() == tacticalMoves.size());
-
-        for (const Move m : legalMoves) {
+        for (const Move m : legalMoves)
             CHECK(evasions.contains(m));
-            CHECK(tacticalMoves.contains(m));
-        }
     }
-    else {
-        size_t tacticalCount = 0;
 
-        for (const Move m : legalMoves) {
-            if (m.isCapture() || m.isPromotion()) {
-                ++tacticalCount;
-                CHECK(tacticalMoves.contains(m));
-            }
-        }
+    // Tactical and Quiets partition the legal moves, in or out of check
+    REQUIRE(tacticalMoves.size() + quietMoves.size() == legalMoves.size());
 
-        for (const Move m : tacticalMoves) {
-            CHECK((m.isCapture() || m.isPromotion()));
-            CHECK(legalMoves.contains(m));
-        }
+    for (const Move m : tacticalMoves) {
+        CHECK((m.isCapture() || m.isPromotion()));
+        CHECK(legalMoves.contains(m));
+    }
+
+    size_t quietCheckCount = 0;
+    for (const Move m : quietMoves) {
+        CHECK_FALSE((m.isCapture() || m.isPromotion()));
+        CHECK(legalMoves.contains(m));
 
-        CHECK(tacticalCount == tacticalMoves.size());
+        // QuietChecks is exactly the subset of quiet moves that leave the opponent in check
+        UndoInfo u{};
+        pos.makeMove(m, u);
+        const bool givesCheck = pos.inCheck();
+        pos.undoMove(m, u);
+
+        CHECK(quietChecks.contains(m) == givesCheck);
+        quietCheckCount += givesCheck ? 1 : 0;
     }
+    CHECK(quietCheckCount == quietChecks.size());
 
     for (const Move m : legalMoves) {
         UndoInfo u{};
@@ -234,13 +302,48 @@ TEST_CASE("Perft", "[perft][movegen]") {
     for (const auto& tc : cases) {
         for (auto [depth, expected] : tc.checks) {
             Position pos = Position::fromFEN(tc.fen);
-            const uint64_t got = perft(pos, depth);
+            const uint64_t got = engine::perft(pos, depth);
 
             INFO(tc.name << " depth=" << depth);
             CHECK(got == expected);
             if (got != expected) {
                 divide(pos, depth);
             }
+            // The pseudo-legal path is slower without bulk counting, so only compare it at shallow depths
+            if (depth <= 4)
+                CHECK(perft_pseudo_legal(pos, depth) == expected);
+        }
+    }
+}
+
+// The perft table and the root split must not change any count, including with a table small enough to be overwritten.
+TEST_CASE("Hashed Parallel Perft", "[perft][movegen]") {
+    engine::init_engine();
+
+    const std::vector<const char*> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    };
+
+    engine::PerftTable table(1);
+    for (const char* fen : fens) {
+        Position pos = Position::fromFEN(fen);
+        const uint64_t expected = engine::perft(pos, 4);
+
+        INFO(fen);
+        for (const int threads : {1, 3}) {
+            const engine::PerftResult result = engine::run_perft(pos, 4, threads, &table);
+            CHECK(result.nodes == expected);
+            CHECK(result.divide.size() == MoveList(pos).size());
+
+            for (const auto& [move, nodes] : result.divide) {
+                UndoInfo u{};
+                pos.makeMove(move, u);
+                CHECK(nodes == engine::perft(pos, 3));
+                pos.undoMove(move, u);
+            }
         }
     }
 }
@@ -333,6 +436,11 @@ TEST_CASE("Move Generation Mode Invariants", "[movegen][invariants]") {
             "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
             4,
         },
+        {
+            "Discovered and castling checks",
+            "5k2/8/3P4/8/1B3N2/8/5R2/R3K2R w KQ - 0 1",
+            3,
+        },
     };
     // clang-format on
 
@@ -342,6 +450,40 @@ TEST_CASE("Move Generation Mode Invariants", "[movegen][invariants]") {
     }
 }
 
+// Tests that `isPseudoLegal` accepts exactly the generated pseudo-legal moves, so TT and killer moves can be trusted.
+TEST_CASE("Pseudo-Legality Check", "[movegen][invariants]") {
+    engine::init_engine();
+
+    // clang-format off
+    const std::vector<const char*> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "8/8/8/2k5/3Pp3/8/8/4K2Q b - d3 0 1",
+    };
+    // clang-format on
+
+    for (const char* fen : fens) {
+        Position pos = Position::fromFEN(fen);
+        pseudo_legality_invariants(pos, 2);
+    }
+}
+
+// Quiet leaves without captures must be scored by the static evaluation, not as stalemate.
+TEST_CASE("Quiescence Without Captures", "[search][quiescence]") {
+    engine::init_engine();
+
+    Position pos = Position::fromFEN("4k3/8/8/8/8/8/8/3QK3 w - - 0 1");
+    engine::Search search(nullptr);
+    const engine::SearchResult result = search.search(pos, engine::SearchLimits{.depth = 1});
+
+    CHECK(result.score != kDrawScore);
+    CHECK(result.score > 500);
+}
+
 TEST_CASE("Draw Detection", "[search][draw]") {
     engine::init_engine();
 
@@ -366,3 +508,103 @@ TEST_CASE("Draw Detection", "[search][draw]") {
         CHECK(result.bestMove.isNone());
     }
 }
+
+TEST_CASE("Node Limit", "[search][limits]") {
+    engine::init_engine();
+
+    const Position root = Position::fromFEN(engine::startpos);
+    constexpr uint64_t kNodeLimit = 20000;
+
+    SECTION("Single thread stops exactly at the limit and is reproducible") {
+        const engine::SearchLimits limits{.depth = static_cast<Depth>(kMaxPly - 1), .nodes = kNodeLimit};
+        engine::SearchResult results[2];
+        for (engine::SearchResult& result : results) {
+            TranspositionTable tt(1);
+            engine::SearchSharedState sharedState{};
+            result = engine::runParallelSearch(root, limits, {root.hash()}, &tt, &sharedState);
+        }
+
+        CHECK(results[0].telemetry.nodes + results[0].telemetry.qNodes == kNodeLimit);
+        CHECK(results[0].bestMove == results[1].bestMove);
+        CHECK(results[0].score == results[1].score);
+        CHECK(results[0].telemetry.completedDepth == results[1].telemetry.completedDepth);
+    }
+
+    SECTION("The limit applies to the sum over all threads") {
+        constexpr int kThreads = 3;
+        const engine::SearchLimits limits{.depth = static_cast<Depth>(kMaxPly - 1), .threads = kThreads, .nodes = kNodeLimit};
+        TranspositionTable tt(1);
+        engine::SearchSharedState sharedState{};
+        const engine::SearchResult result = engine::runParallelSearch(root, limits, {root.hash()}, &tt, &sharedState);
+
+        const uint64_t nodes = result.telemetry.nodes + result.telemetry.qNodes;
+        CHECK(nodes >= kNodeLimit);
+        CHECK(nodes <= kNodeLimit + kThreads * 1024);
+        CHECK(!result.bestMove.isNone());
+    }
+}
+
+// While pondering the deadlines are ignored, so a search with expired deadlines still reaches its depth.
+TEST_CASE("Ponder Ignores Deadlines", "[search][ponder]") {
+    engine::init_engine();
+
+    const Position root = Position::fromFEN(engine::startpos);
+    constexpr Depth kDepth = 5;
+    const engine::SearchLimits limits{.depth = kDepth};
+    const auto expired = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+
+    SECTION("Pondering searches to the requested depth") {
+        TranspositionTable tt(1);
+        engine::SearchSharedState sharedState{};
+        sharedState.softDeadline = expired;
+        sharedState.hardDeadline = expired;
+        sharedState.pondering.store(true);
+        const engine::SearchResult result = engine::runParallelSearch(root, limits, {root.hash()}, &tt, &sharedState);
+
+        CHECK(result.telemetry.completedDepth == kDepth);
+        CHECK_FALSE(result.stopped);
+        CHECK_FALSE(result.bestMove.isNone());
+    }
+
+    SECTION("Without pondering the expired deadlines stop the search") {
+        TranspositionTable tt(1);
+        engine::SearchSharedState sharedState{};
+        sharedState.softDeadline = expired;
+        sharedState.hardDeadline = expired;
+        const engine::SearchResult result = engine::runParallelSearch(root, limits, {root.hash()}, &tt, &sharedState);
+
+        CHECK(result.stopped);
+        CHECK(result.telemetry.completedDepth < kDepth);
+    }
+}
+
+TEST_CASE("MultiPV", "[search][multipv]") {
+    engine::init_engine();
+
+    Position pos = Position::fromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    engine::Search single(nullptr);
+    const engine::SearchResult singleResult = single.search(pos, engine::SearchLimits{.depth = 4});
+    CHECK(singleResult.lines.empty());
+
+    engine::Search multi(nullptr);
+    const engine::SearchResult result = multi.search(pos, engine::SearchLimits{.depth = 4, .multiPV = 4});
+
+    REQUIRE(result.lines.size() == 4);
+    CHECK(result.score == singleResult.score);
+    CHECK(result.bestMove == singleResult.bestMove);
+    CHECK(result.lines[0].score == result.score);
+    CHECK(result.lines[0].pv[0] == result.bestMove);
+    for (size_t i = 0; i < result.lines.size(); ++i) {
+        REQUIRE(result.lines[i].pvLength > 0);
+        if (i > 0)
+            CHECK(result.lines[i].score <= result.lines[i - 1].score);
+        for (size_t j = 0; j < i; ++j)
+            CHECK(result.lines[i].pv[0] != result.lines[j].pv[0]);
+    }
+
+    // More lines than legal moves reports every move once
+    Position kings = Position::fromFEN("8/8/8/8/8/8/8/K6k w - - 0 1");
+    engine::Search all(nullptr);
+    const engine::SearchResult allResult = all.search(kings, engine::SearchLimits{.depth = 2, .multiPV = 10});
+    CHECK(allResult.lines.size() == MoveList(kings).size());
+}
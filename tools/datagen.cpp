@@ -0,0 +1,413 @@
+// This tool generates scored training positions by playing self-play games with fixed-node searches
+// Build and run with: `cmake --build build --target datagen && ./build/datagen --output data.bin [options]`
+//
+// Each game thread owns its own `Search` and transposition table, so threads share nothing but the output file.
+// Games start from `--random-plies` random moves, played from the start position or from a random `--book` EPD line.
+// Positions are recorded when the side to move is not in check, the best move is quiet and the score is not a mate;
+// they are written once the game result is known, as 32-byte `PackedPosition` records (see below).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "engine.h"
+#include "move_gen/generator.h"
+#include "position.h"
+#include "search.h"
+#include "transposition_table.h"
+
+namespace {
+
+// Little-endian on-disk record of one scored position.
+// Pieces are stored as 4-bit `Piece` codes (low nibble first), in the order of the set bits of `occupancy`.
+struct PackedPosition {
+    uint64_t occupancy;
+    std::array<uint8_t, 16> pieces;
+    int16_t score;      // Search score from White's point of view, in centipawns
+    uint8_t result;     // 0 = Black win, 1 = draw, 2 = White win
+    uint8_t flags;      // Bit 0: side to move (1 = Black), bits 1-4: castling rights
+    uint8_t epSquare;   // Candidate en passant square, or 64 if none
+    uint8_t halfmoveClock;
+    uint16_t fullmoveNumber;
+};
+static_assert(sizeof(PackedPosition) == 32);
+
+struct Options {
+    std::string outputPath;
+    std::string bookPath;
+    size_t threads = std::max(1U, std::thread::hardware_concurrency());
+    uint64_t games = 1000;
+    uint64_t nodes = 5000;
+    int randomPlies = 8;
+    size_t hashMB = 16;
+    uint64_t seed = std::random_device{}();
+};
+
+// Adjudication thresholds
+constexpr Eval kWinAdjudicationScore = 1000;  // Both sides agree on a score at least this large for `kWinPlies` plies
+constexpr int kWinPlies = 4;
+constexpr Eval kDrawAdjudicationScore = 10;   // Scores within this window for `kDrawPlies` plies, after `kDrawMinPly`
+constexpr int kDrawPlies = 8;
+constexpr int kDrawMinPly = 80;
+constexpr int kMaxGamePly = 400;
+constexpr size_t kFlushRecords = 1 << 14;  // Records buffered per thread before taking the output lock
+
+enum class GameResult : uint8_t { BlackWin, Draw, WhiteWin, Ongoing };
+
+PackedPosition pack(const Position& pos, Eval whiteScore) noexcept {
+    PackedPosition packed{};
+    packed.occupancy = pos.occupancy();
+
+    Bitboard occupied = pos.occupancy();
+    for (size_t i = 0; occupied; ++i) {
+        const auto sq = static_cast<Square>(pop_lsb(occupied));
+        packed.pieces[i / 2] |= static_cast<uint8_t>(to_underlying(pos.pieceOn(sq)) << ((i % 2) * 4));
+    }
+
+    packed.score = static_cast<int16_t>(std::clamp<Eval>(whiteScore, INT16_MIN, INT16_MAX));
+    packed.flags = static_cast<uint8_t>(
+        (pos.sideToMove() == Color::Black ? 1 : 0) | (to_underlying(pos.castlingRights()) << 1)
+    );
+    packed.epSquare = static_cast<uint8_t>(to_underlying(pos.epSquare()));
+    packed.halfmoveClock = pos.halfmoveClock();
+    packed.fullmoveNumber = pos.fullmoveNumber();
+    return packed;
+}
+
+bool insufficient_material(const Position& pos) noexcept {
+    for (const Color c : {Color::White, Color::Black}) {
+        if (pos.get(c, PieceType::Pawn) || pos.get(c, PieceType::Rook) || pos.get(c, PieceType::Queen))
+            return false;
+    }
+
+    const Bitboard minors = pos.get(Color::White, PieceType::Knight) | pos.get(Color::White, PieceType::Bishop) |
+                            pos.get(Color::Black, PieceType::Knight) | pos.get(Color::Black, PieceType::Bishop);
+    return bit_count(minors) <= 1;
+}
+
+// Counts how often the current position occurred since the last irreversible move, including itself.
+int repetitions(const Position& pos, const std::vector<Key>& history) noexcept {
+    const size_t window = std::min(history.size(), static_cast<size_t>(pos.halfmoveClock()) + 1);
+    return static_cast<int>(std::count(history.end() - static_cast<std::ptrdiff_t>(window), history.end(), pos.hash()));
+}
+
+// Returns the result decided by the rules alone, before any search.
+GameResult rules_result(const Position& pos, const MoveList& moves, const std::vector<Key>& history) noexcept {
+    if (moves.empty()) {
+        if (!pos.inCheck())
+            return GameResult::Draw;
+        return pos.sideToMove() == Color::White ? GameResult::BlackWin : GameResult::WhiteWin;
+    }
+
+    if (pos.halfmoveClock() >= 100 || insufficient_material(pos) || repetitions(pos, history) >= 3)
+        return GameResult::Draw;
+    return GameResult::Ongoing;
+}
+
+// Shared output file; each thread appends whole games in batches.
+class RecordWriter {
+public:
+    explicit RecordWriter(const std::string& path)
+        : buffer_(size_t{1} << 20) {
+        file_.rdbuf()->pubsetbuf(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        file_.open(path, std::ios::binary | std::ios::trunc);
+        if (!file_)
+            throw std::runtime_error("Failed to open " + path);
+    }
+
+    void write(std::vector<PackedPosition>& records) {
+        if (records.empty())
+            return;
+
+        const std::lock_guard lock(mutex_);
+        file_.write(
+            reinterpret_cast<const char*>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(PackedPosition))
+        );
+        if (!file_)
+            throw std::runtime_error("Failed to write training records");
+        records.clear();
+    }
+
+    void flush() {
+        const std::lock_guard lock(mutex_);
+        file_.flush();
+    }
+
+private:
+    std::vector<char> buffer_;
+    std::ofstream file_;
+    std::mutex mutex_;
+};
+
+struct Progress {
+    std::atomic<uint64_t> gamesStarted{};
+    std::atomic<uint64_t> gamesFinished{};
+    std::atomic<uint64_t> positions{};
+    std::atomic<bool> failed{};  // Set by a game thread that threw, so every other thread winds down
+};
+
+class GameThread {
+public:
+    GameThread(const Options& options, const std::vector<std::string>& book, size_t threadId)
+        : options_(options), book_(book), rng_(options.seed + threadId), tt_(options.hashMB), search_(&tt_) {}
+
+    void run(RecordWriter& writer, Progress& progress) {
+        std::vector<PackedPosition> records;
+        while (!progress.failed.load(std::memory_order_relaxed) &&
+               progress.gamesStarted.fetch_add(1, std::memory_order_relaxed) < options_.games) {
+            const size_t before = records.size();
+            playGame_(records);
+            progress.positions.fetch_add(records.size() - before, std::memory_order_relaxed);
+            progress.gamesFinished.fetch_add(1, std::memory_order_relaxed);
+
+            if (records.size() >= kFlushRecords)
+                writer.write(records);
+        }
+        writer.write(records);
+    }
+
+private:
+    const Options& options_;
+    const std::vector<std::string>& book_;
+    std::mt19937_64 rng_;
+    TranspositionTable tt_;
+    engine::Search search_;
+
+    // Plays the opening random plies, retrying until they leave a position that is still in play.
+    Position openingPosition_(std::vector<Key>& history) {
+        while (true) {
+            Position pos = Position::fromFEN(engine::startpos);
+            if (!book_.empty())
+                pos = Position::fromFEN(book_[rng_() % book_.size()]);
+
+            history.assign(1, pos.hash());
+            bool playable = true;
+            for (int ply = 0; ply < options_.randomPlies && playable; ++ply) {
+                const MoveList moves(pos);
+                if (moves.empty()) {
+                    playable = false;
+                    break;
+                }
+
+                UndoInfo undo;
+                pos.makeMove(moves[static_cast<int>(rng_() % moves.size())], undo);
+                history.push_back(pos.hash());
+            }
+
+            if (playable && rules_result(pos, MoveList(pos), history) == GameResult::Ongoing)
+                return pos;
+        }
+    }
+
+    void playGame_(std::vector<PackedPosition>& records) {
+        std::vector<Key> history;
+        Position pos = openingPosition_(history);
+        tt_.clear();
+
+        const size_t firstRecord = records.size();
+        engine::SearchLimits limits{};
+        limits.depth = kMaxPly - 1;
+        limits.nodes = options_.nodes;
+
+        GameResult result = GameResult::Ongoing;
+        int winPlies = 0;  // Signed: consecutive plies above the win score for White (> 0) or for Black (< 0)
+        int drawPlies = 0;
+
+        for (int ply = 0; result == GameResult::Ongoing; ++ply) {
+            const MoveList moves(pos);
+            result = rules_result(pos, moves, history);
+            if (result != GameResult::Ongoing)
+                break;
+            if (ply >= kMaxGamePly) {
+                result = GameResult::Draw;
+                break;
+            }
+
+            tt_.newSearch();
+            search_.setPositionHistory(history);
+            const engine::SearchResult searchResult = search_.search(pos, limits);
+            const Move best = searchResult.bestMove;
+            const Eval whiteScore = engine::absolute_eval(searchResult.score, pos.sideToMove());
+
+            if (is_mate_score(whiteScore)) {
+                result = whiteScore > 0 ? GameResult::WhiteWin : GameResult::BlackWin;
+                break;
+            }
+
+            if (whiteScore >= kWinAdjudicationScore)
+                winPlies = std::max(winPlies, 0) + 1;
+            else if (whiteScore <= -kWinAdjudicationScore)
+                winPlies = std::min(winPlies, 0) - 1;
+            else
+                winPlies = 0;
+            drawPlies = (ply >= kDrawMinPly && std::abs(whiteScore) <= kDrawAdjudicationScore) ? drawPlies + 1 : 0;
+            if (std::abs(winPlies) >= kWinPlies) {
+                result = winPlies > 0 ? GameResult::WhiteWin : GameResult::BlackWin;
+                break;
+            }
+            if (drawPlies >= kDrawPlies) {
+                result = GameResult::Draw;
+                break;
+            }
+
+            if (!pos.inCheck() && !best.isCapture() && !best.isPromotion())
+                records.push_back(pack(pos, whiteScore));
+
+            UndoInfo undo;
+            pos.makeMove(best, undo);
+            if (pos.halfmoveClock() == 0)
+                history.clear();
+            history.push_back(pos.hash());
+        }
+
+        for (size_t i = firstRecord; i < records.size(); ++i)
+            records[i].result = static_cast<uint8_t>(to_underlying(result));
+    }
+};
+
+std::vector<std::string> load_book(const std::string& path) {
+    std::vector<std::string> book;
+    if (path.empty())
+        return book;
+
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("Failed to open " + path);
+
+    // Keep the four EPD position fields; opcodes are ignored and move counters are reset
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line.starts_with('#'))
+            continue;
+
+        std::istringstream fields(line);
+        std::array<std::string, 4> epd;
+        if (!(fields >> epd[0] >> epd[1] >> epd[2] >> epd[3]))
+            throw std::runtime_error("Malformed EPD line in " + path + ": " + line);
+        book.push_back(std::format("{} {} {} {} 0 1", epd[0], epd[1], epd[2], epd[3]));
+    }
+
+    if (book.empty())
+        throw std::runtime_error("No positions in " + path);
+    return book;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--output" && i + 1 < argc) {
+            options.outputPath = argv[++i];
+        }
+        else if (arg == "--book" && i + 1 < argc) {
+            options.bookPath = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1UL, std::stoul(argv[++i]));
+        }
+        else if (arg == "--games" && i + 1 < argc) {
+            options.games = std::stoull(argv[++i]);
+        }
+        else if (arg == "--nodes" && i + 1 < argc) {
+            options.nodes = std::max(1ULL, std::stoull(argv[++i]));
+        }
+        else if (arg == "--random-plies" && i + 1 < argc) {
+            options.randomPlies = std::stoi(argv[++i]);
+        }
+        else if (arg == "--hash" && i + 1 < argc) {
+            options.hashMB = std::stoul(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::stoull(argv[++i]);
+        }
+        else {
+            throw std::invalid_argument("Unknown argument: " + std::string(arg));
+        }
+    }
+
+    if (options.outputPath.empty()) {
+        throw std::invalid_argument(
+            "Usage: datagen --output FILE [--games N] [--threads N] [--nodes N] [--random-plies N] [--book FILE] "
+            "[--hash MB] [--seed N]"
+        );
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = parse_options(argc, argv);
+        engine::init_engine();
+
+        const std::vector<std::string> book = load_book(options.bookPath);
+        RecordWriter writer(options.outputPath);
+        Progress progress;
+
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(options.threads);
+            for (size_t i = 0; i < options.threads; ++i) {
+                workers.emplace_back([&, i] {
+                    try {
+                        GameThread(options, book, i).run(writer, progress);
+                    }
+                    catch (...) {
+                        const std::lock_guard lock(errorMutex);
+                        if (!error)
+                            error = std::current_exception();
+                        progress.failed.store(true, std::memory_order_relaxed);
+                    }
+                });
+            }
+
+            uint64_t reported = 0;
+            while (!progress.failed.load(std::memory_order_relaxed) &&
+                   progress.gamesFinished.load(std::memory_order_relaxed) < options.games) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                const uint64_t finished = progress.gamesFinished.load(std::memory_order_relaxed);
+                if (finished / 100 == reported / 100)
+                    continue;
+
+                reported = finished;
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                const uint64_t positions = progress.positions.load(std::memory_order_relaxed);
+                std::cerr << std::format(
+                    "games {} positions {} ({:.0f} positions/s)\n", finished, positions, positions / seconds
+                );
+            }
+        }
+        if (error)
+            std::rethrow_exception(error);
+        writer.flush();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << std::format(
+            "Wrote {} positions from {} games in {:.1f}s\n", progress.positions.load(), options.games, seconds
+        );
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error generating data: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
@@ -1,10 +1,18 @@
 // This script finds magic numbers for rook and bishop move generation
 // Build and run with: `cmake --build build --target run-find-magics`
+//
+// All 128 squares are searched in parallel. With `--shrink`, each square then keeps looking for magics using fewer
+// index bits than its mask has relevant bits (relying on constructive collisions), which shrinks the packed tables.
+// The achieved table sizes are reported on stderr, keeping stdout for the generated header.
 
 #include <algorithm>
+#include <atomic>
 #include <format>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <span>
+#include <thread>
 
 #include "move_gen/attacks_sliders.h"
 #include "types.h"
@@ -12,36 +20,77 @@
 
 namespace {
 
+struct Options {
+    size_t threads = std::max(1U, std::thread::hardware_concurrency());
+    bool shrink = false;
+    uint64_t attempts = 50'000'000;  // Attempts per square for each reduced bit count with `--shrink`
+};
+
 inline uint64_t sparse_rand64(std::mt19937_64& rng) noexcept {
     // Sparse randoms (few bits set) are more likely to produce good magic numbers
     // NOLINTNEXTLINE(misc-redundant-expression): We intentionally AND multiple rands together
     return rng() & rng() & rng();
 }
 
-Magic find_magic_for_square(
-    Bitboard mask,
-    int relevantBits,
-    std::span<Bitboard> occs,
-    std::span<Bitboard> atts,
+// All blocker configurations of one square with their attacks, enumerated once and shared by every attempt
+struct SquareJob {
+    PieceType pieceType;
+    size_t square;
+    Bitboard mask;
+    std::vector<Bitboard> occs;
+    std::vector<Bitboard> atts;
+};
+
+// Index table of a single magic attempt. An entry only counts as used when its generation matches the current attempt,
+// so starting a new attempt is a counter increment instead of refilling the whole table.
+class AttemptTable {
+public:
+    explicit AttemptTable(size_t size) : attacks_(size), generations_(size, 0) {}
+
+    void nextAttempt() noexcept {
+        if (++generation_ == 0) {
+            // The counter wrapped around, so stale entries could match again
+            std::ranges::fill(generations_, 0U);
+            generation_ = 1;
+        }
+    }
+
+    // Records the attacks at the index, returning false on a destructive collision with a different attack set.
+    bool insert(size_t idx, Bitboard attacks) noexcept {
+        if (generations_[idx] != generation_) {
+            generations_[idx] = generation_;
+            attacks_[idx] = attacks;
+            return true;
+        }
+        return attacks_[idx] == attacks;
+    }
+
+private:
+    std::vector<Bitboard> attacks_;
+    std::vector<uint32_t> generations_;
+    uint32_t generation_ = 0;
+};
+
+// Searches for a magic with `indexBits` index bits, giving up after `maxAttempts` attempts (0 = never give up).
+std::optional<Magic> find_magic_for_square(
+    const SquareJob& job,
+    int indexBits,
+    uint64_t maxAttempts,
+    AttemptTable& table,
     std::mt19937_64& rng
 ) {
-    const size_t tableSize = 1U << relevantBits;
-    std::vector<Bitboard> used(tableSize);
+    for (uint64_t attempt = 0; maxAttempts == 0 || attempt < maxAttempts; ++attempt) {
+        // The table offset is assigned once every square has its magic
+        const Magic magic{job.mask, sparse_rand64(rng), static_cast<uint8_t>(64 - indexBits), 0};
 
-    while (true) {
-        Magic magic{mask, sparse_rand64(rng), static_cast<uint8_t>(64 - relevantBits)};
-
-        std::ranges::fill(used.begin(), used.end(), 0ULL);
+        // Good magics map the mask's bits onto the top byte; skip candidates that leave it sparse
+        if (bit_count((job.mask * magic.magic) & 0xFF00000000000000ULL) < 6)
+            continue;
 
+        table.nextAttempt();
         bool collision = false;
-        for (size_t i = 0; i < occs.size(); ++i) {
-            const size_t idx = magic_index(magic, occs[i]);
-            const Bitboard a = atts[i];
-
-            if (used[idx] == 0ULL) {
-                used[idx] = a;
-            }
-            else if (used[idx] != a) {
+        for (size_t i = 0; i < job.occs.size(); ++i) {
+            if (!table.insert(magic_index(magic, job.occs[i]), job.atts[i])) {
                 collision = true;
                 break;
             }
@@ -50,42 +99,104 @@ Magic find_magic_for_square(
         if (!collision)
             return magic;
     }
+    return std::nullopt;
 }
 
-std::array<Magic, 64> find_magics(PieceType pieceType) {
-    std::array<Magic, 64> out{};
+SquareJob make_job(PieceType pieceType, size_t s) {
+    const auto sq = static_cast<Square>(s);
+    const bool isRook = pieceType == PieceType::Rook;
+    const Bitboard mask = isRook ? rook_mask(sq) : bishop_mask(sq);
+    const size_t count = 1U << bit_count(mask);
 
-    std::random_device rd;
-    std::mt19937_64 rng(rd());
+    SquareJob job{pieceType, s, mask, {}, {}};
+    job.occs.reserve(count);
+    job.atts.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Bitboard occ = index_to_occupancy(mask, i);
+        job.occs.push_back(occ);
+        job.atts.push_back(isRook ? rook_attacks_ray(sq, occ) : bishop_attacks_ray(sq, occ));
+    }
+    return job;
+}
 
-    const bool isRook = pieceType == PieceType::Rook;
+// Finds the magic of one square: a standard one first, then with `--shrink` ones with ever fewer index bits.
+Magic solve_square(const SquareJob& job, const Options& options, std::mt19937_64& rng) {
+    const int relevantBits = bit_count(job.mask);
+    AttemptTable table(size_t{1} << relevantBits);
 
-    for (size_t s = 0; s < 64; ++s) {
-        const auto sq = static_cast<Square>(s);
-        const Bitboard mask = isRook ? rook_mask(sq) : bishop_mask(sq);
-        const int relevantBits = bit_count(mask);
-        const size_t count = 1U << relevantBits;
-
-        std::vector<Bitboard> occs;
-        std::vector<Bitboard> atts;
-        occs.reserve(count);
-        atts.reserve(count);
-
-        for (size_t i = 0; i < count; ++i) {
-            const Bitboard occ = index_to_occupancy(mask, i);
-            const Bitboard att = isRook ? rook_attacks_ray(sq, occ) : bishop_attacks_ray(sq, occ);
-            occs.push_back(occ);
-            atts.push_back(att);
-        }
+    Magic best = *find_magic_for_square(job, relevantBits, 0, table, rng);
+    if (!options.shrink)
+        return best;
 
-        const Magic magic = find_magic_for_square(mask, relevantBits, occs, atts, rng);
-        out[s] = magic;
+    for (int bits = relevantBits - 1; bits > 0; --bits) {
+        const auto smaller = find_magic_for_square(job, bits, options.attempts, table, rng);
+        if (!smaller)
+            break;
+        best = *smaller;
     }
+    return best;
+}
 
-    return out;
+struct MagicSet {
+    std::array<Magic, 64> rooks{};
+    std::array<Magic, 64> bishops{};
+};
+
+MagicSet find_magics(const Options& options) {
+    std::vector<SquareJob> jobs;
+    jobs.reserve(128);
+    for (const PieceType pieceType : {PieceType::Rook, PieceType::Bishop}) {
+        for (size_t s = 0; s < 64; ++s)
+            jobs.push_back(make_job(pieceType, s));
+    }
+    // Start with the slowest squares (most relevant bits) so they do not end up alone at the tail
+    std::ranges::sort(jobs, std::greater{}, [](const SquareJob& job) { return bit_count(job.mask); });
+
+    MagicSet result;
+    std::atomic<size_t> nextJob{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    const uint64_t seed = std::random_device{}();
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(options.threads);
+        for (size_t t = 0; t < options.threads; ++t) {
+            workers.emplace_back([&, t] {
+                try {
+                    std::mt19937_64 rng(seed + t);
+                    for (size_t i = nextJob.fetch_add(1); i < jobs.size(); i = nextJob.fetch_add(1)) {
+                        const SquareJob& job = jobs[i];
+                        auto& magics = (job.pieceType == PieceType::Rook) ? result.rooks : result.bishops;
+                        magics[job.square] = solve_square(job, options, rng);
+                    }
+                }
+                catch (...) {
+                    const std::lock_guard lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    nextJob.store(jobs.size());
+                }
+            });
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    return result;
 }
 
-std::string magics_to_string(std::string_view name, const std::array<Magic, 64>& arr) {
+// Packs the per-square attack tables back to back ("fancy" magics), returning the total number of entries.
+size_t assign_offsets(std::array<Magic, 64>& arr) noexcept {
+    size_t offset = 0;
+    for (Magic& m : arr) {
+        m.offset = static_cast<uint32_t>(offset);
+        offset += size_t{1} << (64 - m.shift);
+    }
+    return offset;
+}
+
+std::string magics_to_string(std::string_view name, std::string_view sizeName, std::array<Magic, 64>& arr) {
+    const size_t tableSize = assign_offsets(arr);
     std::string out{};
 
     out += std::format("inline constexpr std::array<Magic, 64> {} = {{{{\n", name);
@@ -94,16 +205,17 @@ std::string magics_to_string(std::string_view name, const std::array<Magic, 64>&
         const Magic& m = arr[i];
 
         out += std::format(
-            "    {{ 0x{:016x}, 0x{:016x}, {} }}{}{}\n",
+            "    {{ 0x{:016x}, 0x{:016x}, {}, {} }}{}\n",
             static_cast<uint64_t>(m.mask),
             m.magic,
             static_cast<unsigned>(m.shift),
-            (i == 63 ? "" : ","),
-            ""
+            m.offset,
+            (i == 63 ? "" : ",")
         );
     }
 
     out += "}};\n";
+    out += std::format("inline constexpr size_t {} = {};\n", sizeName, tableSize);
     return out;
 }
 
@@ -112,22 +224,70 @@ std::string header_to_string() {
     header += "// Auto generated by tools/find_magics.cpp\n\n";
     header += "#pragma once\n";
     header += "#include <array>\n";
+    header += "#include <cstddef>\n";
     header += "#include \"magic_types.h\"\n";
     return header;
 }
 
+// Prints the packed table size achieved, and how many squares use fewer index bits than relevant mask bits.
+void report_table_size(std::string_view name, const std::array<Magic, 64>& arr) {
+    size_t entries = 0;
+    size_t standardEntries = 0;
+    int reducedSquares = 0;
+    for (const Magic& m : arr) {
+        const int indexBits = 64 - m.shift;
+        entries += size_t{1} << indexBits;
+        standardEntries += size_t{1} << bit_count(m.mask);
+        reducedSquares += (indexBits < bit_count(m.mask)) ? 1 : 0;
+    }
+    std::cerr << std::format(
+        "{}: {} entries ({:.1f} KiB), standard shifts {} entries ({:.1f} KiB), {} squares reduced\n",
+        name,
+        entries,
+        static_cast<double>(entries * sizeof(Bitboard)) / 1024.0,
+        standardEntries,
+        static_cast<double>(standardEntries * sizeof(Bitboard)) / 1024.0,
+        reducedSquares
+    );
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1UL, std::stoul(argv[++i]));
+        }
+        else if (arg == "--shrink") {
+            options.shrink = true;
+        }
+        else if (arg == "--attempts" && i + 1 < argc) {
+            options.attempts = std::max(1ULL, std::stoull(argv[++i]));
+        }
+        else {
+            throw std::invalid_argument(
+                "Unknown argument: " + std::string(arg) + "\nUsage: find_magics [--threads N] [--shrink] [--attempts N]"
+            );
+        }
+    }
+    return options;
+}
+
 }  // namespace
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
-        auto rookMagics = find_magics(PieceType::Rook);
-        auto bishopMagics = find_magics(PieceType::Bishop);
+        const Options options = parse_options(argc, argv);
+        MagicSet magics = find_magics(options);
 
         std::string out{};
         out += header_to_string() + "\n";
-        out += magics_to_string("kRookMagics", rookMagics) + "\n";
-        out += magics_to_string("kBishopMagics", bishopMagics);
+        out += magics_to_string("kRookMagics", "kRookTableSize", magics.rooks) + "\n";
+        out += magics_to_string("kBishopMagics", "kBishopTableSize", magics.bishops);
         std::cout << out;
+
+        report_table_size("Rook", magics.rooks);
+        report_table_size("Bishop", magics.bishops);
     }
     catch (const std::exception& e) {
         std::cerr << "Error finding magics: " << e.what() << "\n";
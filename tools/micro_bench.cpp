@@ -0,0 +1,268 @@
+// This tool times the hot engine primitives (move generation, make/undo, evaluation, TT and slider attacks)
+// Build and run with: `cmake --build build --target micro_bench && ./build/micro_bench [--filter TEXT] [options]`
+//
+// The corpus is the bench positions plus the positions along a short seeded random walk from each, so the numbers
+// reflect realistic piece counts rather than a single position. Each benchmark is calibrated to run for at least
+// `--sample-ms` per sample, and the median and fastest of `--samples` samples are reported per operation, in
+// nanoseconds and in time stamp counter cycles. The TSC ticks at a fixed reference rate, so with turbo or frequency
+// scaling it differs from core cycles; pin the clock for comparisons across builds.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "bench.h"
+#include "engine.h"
+#include "evaluation.h"
+#include "move_gen/attacks.h"
+#include "move_gen/generator.h"
+#include "position.h"
+#include "transposition_table.h"
+
+namespace {
+
+struct Options {
+    std::string filter;
+    int samples = 15;
+    int sampleMs = 50;
+    int walkPlies = 16;  // Random plies played from each bench position to grow the corpus
+};
+
+// Written by every benchmark so the measured work cannot be optimized away
+volatile uint64_t gSink = 0;
+
+uint64_t read_tsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+class Harness {
+public:
+    explicit Harness(const Options& options) : options_(options) {
+        std::cout << std::format("{:<30} {:>12} {:>12} {:>12}\n", "benchmark", "ns/op", "cycles/op", "min ns/op");
+    }
+
+    // Times `body`, one pass of which performs `opsPerPass` operations and returns a value to sink.
+    template <typename Body>
+    void run(std::string_view name, uint64_t opsPerPass, Body&& body) {
+        if (!options_.filter.empty() && name.find(options_.filter) == std::string_view::npos)
+            return;
+
+        // Calibrate (and warm up) by doubling the passes per sample until a sample takes long enough
+        const auto minSample = std::chrono::milliseconds(options_.sampleMs);
+        uint64_t passes = 1;
+        while (measure_(passes, opsPerPass, body).elapsed < minSample)
+            passes *= 2;
+
+        std::vector<Measurement> measurements;
+        measurements.reserve(static_cast<size_t>(options_.samples));
+        for (int i = 0; i < options_.samples; ++i)
+            measurements.push_back(measure_(passes, opsPerPass, body));
+        std::ranges::sort(measurements, {}, &Measurement::nsPerOp);
+
+        const Measurement& median = measurements[measurements.size() / 2];
+        std::cout << std::format(
+            "{:<30} {:>12.2f} {:>12.1f} {:>12.2f}\n", name, median.nsPerOp, median.cyclesPerOp, measurements[0].nsPerOp
+        );
+    }
+
+private:
+    struct Measurement {
+        std::chrono::steady_clock::duration elapsed;
+        double nsPerOp;
+        double cyclesPerOp;
+    };
+
+    template <typename Body>
+    static Measurement measure_(uint64_t passes, uint64_t opsPerPass, Body& body) {
+        uint64_t sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t startTsc = read_tsc();
+        for (uint64_t i = 0; i < passes; ++i)
+            sink += static_cast<uint64_t>(body());
+        const uint64_t cycles = read_tsc() - startTsc;
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        gSink = gSink + sink;
+
+        const auto ops = static_cast<double>(passes * opsPerPass);
+        return Measurement{
+            .elapsed = elapsed,
+            .nsPerOp = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / ops,
+            .cyclesPerOp = static_cast<double>(cycles) / ops,
+        };
+    }
+
+    const Options& options_;
+};
+
+std::vector<Position> build_corpus(int walkPlies) {
+    std::vector<Position> corpus;
+    std::mt19937_64 rng(0x5EED);
+    for (const std::string_view fen : engine::bench_positions()) {
+        Position pos = Position::fromFEN(fen);
+        corpus.push_back(pos);
+        for (int ply = 0; ply < walkPlies; ++ply) {
+            const MoveList moves(pos);
+            if (moves.empty())
+                break;
+            UndoInfo u{};
+            pos.makeMove(moves[static_cast<int>(rng() % moves.size())], u);
+            corpus.push_back(pos);
+        }
+    }
+    return corpus;
+}
+
+void run_benchmarks(const Options& options) {
+    std::vector<Position> corpus = build_corpus(options.walkPlies);
+    std::vector<MoveList> legalMoves;
+    uint64_t totalMoves = 0;
+    for (const Position& pos : corpus) {
+        legalMoves.emplace_back(pos);
+        totalMoves += legalMoves.back().size();
+    }
+    std::cout << std::format("corpus: {} positions, {} legal moves\n\n", corpus.size(), totalMoves);
+
+    const uint64_t positions = corpus.size();
+    Harness harness(options);
+
+    harness.run("generate_moves", positions, [&] {
+        uint64_t n = 0;
+        for (const Position& pos : corpus)
+            n += MoveList(pos).size();
+        return n;
+    });
+
+    harness.run("generate_moves<Tactical>", positions, [&] {
+        uint64_t n = 0;
+        for (const Position& pos : corpus)
+            n += MoveList(pos, GenMode::Tactical).size();
+        return n;
+    });
+
+    harness.run("generate_pseudo_legal_moves", positions, [&] {
+        uint64_t n = 0;
+        for (const Position& pos : corpus) {
+            MoveList moves;
+            generate_pseudo_legal_moves(pos, moves);
+            n += moves.size();
+        }
+        return n;
+    });
+
+    harness.run("makeMove+undoMove", totalMoves, [&] {
+        uint64_t n = 0;
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            Position& pos = corpus[i];
+            for (const Move m : legalMoves[i]) {
+                UndoInfo u{};
+                pos.makeMove(m, u);
+                n += pos.hash();
+                pos.undoMove(m, u);
+            }
+        }
+        return n;
+    });
+
+    harness.run("evaluation", positions, [&] {
+        uint64_t n = 0;
+        for (const Position& pos : corpus)
+            n += static_cast<uint64_t>(evaluation(pos));
+        return n;
+    });
+
+    TranspositionTable tt(16);
+    for (size_t i = 0; i < corpus.size(); ++i)
+        tt.store(corpus[i].hash(), legalMoves[i].empty() ? Move::none() : legalMoves[i][0], 0, 1, Bound::Exact, 0);
+
+    harness.run("TranspositionTable::probe hit", positions, [&] {
+        uint64_t n = 0;
+        for (const Position& pos : corpus)
+            n += tt.probe(pos.hash()).has_value() ? 1 : 0;
+        return n;
+    });
+
+    harness.run("TranspositionTable::probe miss", positions, [&] {
+        uint64_t n = 0;
+        for (const Position& pos : corpus)
+            n += tt.probe(~pos.hash()).has_value() ? 1 : 0;
+        return n;
+    });
+
+    harness.run("TranspositionTable::store", positions, [&] {
+        for (size_t i = 0; i < corpus.size(); ++i)
+            tt.store(corpus[i].hash(), Move::none(), 0, 1, Bound::Exact, 0);
+        return tt.size();
+    });
+
+    // Every square against every corpus occupancy, so both piece-occupied and empty origin squares are covered
+    const auto runAttacks = [&](std::string_view name, auto attackFn) {
+        harness.run(name, positions * 64, [&] {
+            Bitboard n = 0;
+            for (const Position& pos : corpus) {
+                const Bitboard occ = pos.occupancy();
+                for (size_t s = 0; s < 64; ++s)
+                    n ^= attackFn(static_cast<Square>(s), occ);
+            }
+            return static_cast<uint64_t>(n);
+        });
+    };
+    runAttacks("rook_attacks", [](Square sq, Bitboard occ) { return attacks::rook_attacks(sq, occ); });
+    runAttacks("bishop_attacks", [](Square sq, Bitboard occ) { return attacks::bishop_attacks(sq, occ); });
+    runAttacks("queen_attacks", [](Square sq, Bitboard occ) { return attacks::queen_attacks(sq, occ); });
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        }
+        else if (arg == "--samples" && i + 1 < argc) {
+            options.samples = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--sample-ms" && i + 1 < argc) {
+            options.sampleMs = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--walk-plies" && i + 1 < argc) {
+            options.walkPlies = std::max(0, std::stoi(argv[++i]));
+        }
+        else {
+            throw std::invalid_argument(
+                "Unknown argument: " + std::string(arg) +
+                "\nUsage: micro_bench [--filter TEXT] [--samples N] [--sample-ms N] [--walk-plies N]"
+            );
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = parse_options(argc, argv);
+        engine::init_engine();
+        run_benchmarks(options);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error running micro benchmarks: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
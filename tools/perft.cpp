@@ -0,0 +1,185 @@
+// This tool counts move generation leaf nodes (perft) to benchmark and verify the move generator
+// Build and run with: `cmake --build build --target perft && ./build/perft [--fen FEN] [--depth N] [options]`
+//
+// Root moves are split across `--threads` workers sharing a `--hash` MB table of subtree counts (0 disables it).
+// With `--epd FILE`, every line `<fen> ;D1 <nodes> ;D2 <nodes> ...` is checked up to `--depth` (default: all depths
+// listed), and the exit status reports whether every count matched.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "engine.h"
+#include "perft.h"
+#include "position.h"
+#include "util.h"
+
+namespace {
+
+struct Options {
+    std::string fen{engine::startpos};
+    std::optional<Depth> depth;
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    size_t hashMB = 64;
+    bool divide = false;
+    std::string epdPath;
+};
+
+struct EpdCase {
+    std::string fen;
+    std::vector<std::pair<Depth, uint64_t>> checks;  // (depth, expected nodes)
+};
+
+std::vector<EpdCase> load_epd(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("Failed to open " + path);
+
+    std::vector<EpdCase> cases;
+    std::string line;
+    while (std::getline(file, line)) {
+        trim(line);
+        if (line.empty() || line.starts_with('#'))
+            continue;
+
+        EpdCase tc;
+        std::istringstream fields(line);
+        std::getline(fields, tc.fen, ';');
+        trim(tc.fen);
+
+        for (std::string check; std::getline(fields, check, ';');) {
+            std::istringstream iss(check);
+            std::string depthField;
+            uint64_t nodes = 0;
+            if (!(iss >> depthField >> nodes) || depthField.size() < 2 || depthField[0] != 'D')
+                throw std::runtime_error("Malformed EPD line in " + path + ": " + line);
+            tc.checks.emplace_back(std::stoi(depthField.substr(1)), nodes);
+        }
+        cases.push_back(std::move(tc));
+    }
+
+    if (cases.empty())
+        throw std::runtime_error("No positions in " + path);
+    return cases;
+}
+
+void print_summary(uint64_t nodes, std::chrono::microseconds elapsed) {
+    const auto us = static_cast<uint64_t>(elapsed.count());
+    std::cout << std::format(
+        "Nodes: {}  Time: {:.3f} s  NPS: {}\n",
+        nodes,
+        static_cast<double>(us) / 1e6,
+        us == 0 ? nodes : nodes * 1'000'000 / us
+    );
+}
+
+int run_single(const Options& options, engine::PerftTable* table) {
+    const Position pos = Position::fromFEN(options.fen);
+    const engine::PerftResult result = engine::run_perft(pos, options.depth.value_or(6), options.threads, table);
+
+    if (options.divide) {
+        for (const auto& [move, nodes] : result.divide)
+            std::cout << to_string(move) << ": " << nodes << "\n";
+        std::cout << "\n";
+    }
+    print_summary(result.nodes, result.elapsed);
+    return EXIT_SUCCESS;
+}
+
+int run_epd(const Options& options, engine::PerftTable* table) {
+    const std::vector<EpdCase> cases = load_epd(options.epdPath);
+
+    uint64_t totalNodes = 0;
+    std::chrono::microseconds totalElapsed{};
+    int failures = 0;
+    for (size_t i = 0; i < cases.size(); ++i) {
+        const EpdCase& tc = cases[i];
+        const Position pos = Position::fromFEN(tc.fen);
+        for (const auto& [depth, expected] : tc.checks) {
+            if (options.depth && depth > *options.depth)
+                continue;
+
+            const engine::PerftResult result = engine::run_perft(pos, depth, options.threads, table);
+            totalNodes += result.nodes;
+            totalElapsed += result.elapsed;
+
+            const bool ok = result.nodes == expected;
+            failures += ok ? 0 : 1;
+            std::cout << std::format(
+                "{} #{} D{}: {} (expected {}) {:.3f} s\n",
+                ok ? "PASS" : "FAIL",
+                i + 1,
+                depth,
+                result.nodes,
+                expected,
+                static_cast<double>(result.elapsed.count()) / 1e6
+            );
+            if (!ok && options.divide) {
+                for (const auto& [move, nodes] : result.divide)
+                    std::cout << "  " << to_string(move) << ": " << nodes << "\n";
+            }
+        }
+    }
+
+    std::cout << "\n" << failures << " failed\n";
+    print_summary(totalNodes, totalElapsed);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--fen" && i + 1 < argc) {
+            options.fen = argv[++i];
+        }
+        else if (arg == "--depth" && i + 1 < argc) {
+            options.depth = std::stoi(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--hash" && i + 1 < argc) {
+            options.hashMB = std::stoul(argv[++i]);
+        }
+        else if (arg == "--divide") {
+            options.divide = true;
+        }
+        else if (arg == "--epd" && i + 1 < argc) {
+            options.epdPath = argv[++i];
+        }
+        else {
+            throw std::invalid_argument(
+                "Unknown argument: " + std::string(arg) +
+                "\nUsage: perft [--fen FEN] [--depth N] [--threads N] [--hash MB] [--divide] [--epd FILE]"
+            );
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = parse_options(argc, argv);
+        engine::init_engine();
+
+        engine::PerftTable table(options.hashMB);
+        engine::PerftTable* tablePtr = table.empty() ? nullptr : &table;
+        return options.epdPath.empty() ? run_single(options, tablePtr) : run_epd(options, tablePtr);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error running perft: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
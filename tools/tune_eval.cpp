@@ -0,0 +1,685 @@
+// This tool tunes the linear evaluation weights with Texel's method on a dataset of positions labelled with game results
+// Build and run with: `cmake -S . -B build -DTUNE_EVAL_DATASET=<path> && cmake --build build --target run-tune-eval`
+//
+// Each line of the dataset holds a FEN or EPD position followed by the game result from White's point of view, either
+// as `[1.0]` / `[0.5]` / `[0.0]` or as `"1-0"` / `"1/2-1/2"` / `"0-1"` (e.g. `<fen> c9 "1-0";` or `<fen> [0.5]`).
+// Every position is first resolved to a quiet leaf with a capture-only quiescence search. The leaf's evaluation is
+// then decomposed into a sparse feature vector, so each tuning epoch is a dot product per position instead of a full
+// evaluation. Loading, resolution and the gradient computation are all split across threads.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "engine.h"
+#include "eval_constants.h"
+#include "evaluation.h"
+#include "move_gen/generator.h"
+#include "position.h"
+
+namespace {
+
+constexpr int kMaxResolvePly = 16;
+
+// Layout of the tuned weight vector
+constexpr size_t kMaterialOffset = 0;                       // Pawn..Queen
+constexpr size_t kPstOffset = kMaterialOffset + 5;          // Pawn..King, 64 squares each (from White's view)
+constexpr size_t kMobilityOffset = kPstOffset + (6 * 64);   // Knight..Queen
+constexpr size_t kBishopPairOffset = kMobilityOffset + 4;   // Bishop pair
+constexpr size_t kThreatOffset = kBishopPairOffset + 1;     // By pawn, by minor, by rook, hanging
+constexpr size_t kNumWeights = kThreatOffset + 4;
+
+constexpr std::array<PieceType, 4> kMobilityPieces = {
+    PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen
+};
+
+struct Options {
+    std::string datasetPath;
+    std::string outputPath;
+    size_t threads = std::max(1U, std::thread::hardware_concurrency());
+    size_t maxPositions = 0;  // 0 = whole dataset
+    int epochs = 300;
+    double learningRate = 1.0;
+};
+
+struct Feature {
+    uint16_t index;
+    int16_t coefficient;
+};
+
+// A resolved training position: its evaluation is `fixedScore + sum(weights[f.index] * f.coefficient)`
+struct Entry {
+    size_t firstFeature;  // Offset into the shard's feature pool
+    uint16_t featureCount;
+    int16_t fixedScore;   // Evaluation terms that are not tuned (king safety)
+    float result;         // 1.0 = White win, 0.5 = draw, 0.0 = Black win
+};
+
+// Positions loaded and resolved by one thread. Shards are never merged; each epoch processes them in parallel.
+struct Shard {
+    std::vector<Entry> entries;
+    std::vector<Feature> features;
+    size_t skipped = 0;     // Lines that could not be parsed
+    size_t mismatches = 0;  // Positions where the feature vector does not reproduce `evaluation()`
+};
+
+// A read-only memory mapping of a whole file.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            throw std::system_error(errno, std::generic_category(), "Failed to open " + path);
+
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0)
+            throw std::system_error(errno, std::generic_category(), "Failed to stat " + path);
+
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0)
+            return;
+
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (data == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "Failed to map " + path);
+
+        ::madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+    }
+
+    ~MappedFile() {
+        if (data_ != nullptr)
+            ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const noexcept { return {data_, size_}; }
+
+private:
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+std::vector<std::string_view> split_lines(std::string_view text, size_t maxLines) {
+    std::vector<std::string_view> lines;
+    while (!text.empty() && (maxLines == 0 || lines.size() < maxLines)) {
+        const size_t end = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, end);
+        if (line.ends_with('\r'))
+            line.remove_suffix(1);
+        if (!line.empty())
+            lines.push_back(line);
+        text.remove_prefix(std::min(end + 1, text.size()));
+    }
+    return lines;
+}
+
+bool is_number(std::string_view token) noexcept {
+    return !token.empty() && std::ranges::all_of(token, [](char ch) { return ch >= '0' && ch <= '9'; });
+}
+
+std::optional<float> parse_result(std::string_view text) {
+    if (text.find("1/2-1/2") != std::string_view::npos)
+        return 0.5F;
+    if (text.find("1-0") != std::string_view::npos)
+        return 1.0F;
+    if (text.find("0-1") != std::string_view::npos)
+        return 0.0F;
+
+    const size_t open = text.find('[');
+    const size_t close = text.find(']', open);
+    if (open == std::string_view::npos || close == std::string_view::npos)
+        return std::nullopt;
+
+    const std::string value(text.substr(open + 1, close - open - 1));
+    if (value == "1.0" || value == "1")
+        return 1.0F;
+    if (value == "0.5")
+        return 0.5F;
+    if (value == "0.0" || value == "0")
+        return 0.0F;
+    return std::nullopt;
+}
+
+// Rejects FENs that `Position::fromFEN` cannot safely parse: the board must have 8 ranks of 8 files with only piece
+// letters and exactly one king per side, and the side to move must be `w` or `b`.
+bool is_valid_fen(std::string_view board, std::string_view side) noexcept {
+    if (side != "w" && side != "b")
+        return false;
+
+    int ranks = 1;
+    int files = 0;
+    int whiteKings = 0;
+    int blackKings = 0;
+    for (const char ch : board) {
+        if (ch == '/') {
+            if (files != 8)
+                return false;
+            ++ranks;
+            files = 0;
+        }
+        else if (ch >= '1' && ch <= '8') {
+            files += ch - '0';
+        }
+        else if (std::string_view("pnbrqkPNBRQK").contains(ch)) {
+            ++files;
+            whiteKings += ch == 'K' ? 1 : 0;
+            blackKings += ch == 'k' ? 1 : 0;
+        }
+        else {
+            return false;
+        }
+
+        if (files > 8)
+            return false;
+    }
+    return ranks == 8 && files == 8 && whiteKings == 1 && blackKings == 1;
+}
+
+// Splits a dataset line into its FEN (the four EPD fields plus the move counters, if present) and its result.
+std::optional<std::pair<std::string, float>> parse_line(std::string_view line) {
+    std::vector<std::string_view> tokens;
+    for (const auto token : line | std::views::split(' ')) {
+        if (!token.empty())
+            tokens.emplace_back(token.begin(), token.end());
+    }
+    if (tokens.size() < 5 || !is_valid_fen(tokens[0], tokens[1]))
+        return std::nullopt;
+
+    size_t fenFields = 4;
+    if (tokens.size() > 6 && is_number(tokens[4]) && is_number(tokens[5]))
+        fenFields = 6;
+
+    const size_t fenEnd = static_cast<size_t>(tokens[fenFields - 1].data() - line.data()) + tokens[fenFields - 1].size();
+    const std::optional<float> result = parse_result(line.substr(fenEnd));
+    if (!result)
+        return std::nullopt;
+
+    return std::pair{std::string(line.substr(0, fenEnd)), *result};
+}
+
+Eval capture_order(const Position& pos, Move move) noexcept {
+    PieceType victim = PieceType::None;
+    if (move.moveType() == MoveType::EnPassant)
+        victim = PieceType::Pawn;
+    else if (move.isCapture())
+        victim = piece_type(pos.pieceOn(move.to()));
+
+    Eval score = 16 * kPieceValues[to_underlying(victim)];
+    score -= kPieceValues[to_underlying(piece_type(pos.pieceOn(move.from())))];
+    if (move.isPromotion())
+        score += kPieceValues[to_underlying(move.promotionType())];
+    return score;
+}
+
+// Capture-only quiescence search from the side to move's view. Fills `pv` with the capture sequence to the quiet leaf
+// the score comes from. Standing pat is allowed even in check, as only the leaf matters, not the exact score.
+Eval resolve(Position& pos, Eval alpha, Eval beta, int ply, std::vector<Move>& pv) {
+    pv.clear();
+
+    const Eval standPat = pos.sideToMove() == Color::White ? evaluation(pos) : -evaluation(pos);
+    if (standPat >= beta || ply >= kMaxResolvePly)
+        return standPat;
+    alpha = std::max(alpha, standPat);
+
+    MoveList moves(pos, GenMode::Tactical);
+    std::sort(moves.begin(), moves.end(), [&pos](Move a, Move b) {
+        return capture_order(pos, a) > capture_order(pos, b);
+    });
+
+    std::vector<Move> childPv;
+    for (const Move move : moves) {
+        if (!move.isCapture() && !move.isPromotion())
+            continue;
+
+        UndoInfo undo;
+        pos.makeMove(move, undo);
+        const Eval score = -resolve(pos, -beta, -alpha, ply + 1, childPv);
+        pos.undoMove(move, undo);
+
+        if (score > alpha) {
+            alpha = score;
+            pv.assign(1, move);
+            pv.insert(pv.end(), childPv.begin(), childPv.end());
+            if (alpha >= beta)
+                break;
+        }
+    }
+
+    return alpha;
+}
+
+// Decomposes the evaluation of `pos` into per-weight coefficients and the untuned remainder.
+// Must mirror `evaluation()`; any drift is caught by the check in `load_shard`.
+Eval extract_features(const Position& pos, std::array<int, kNumWeights>& coefficients) {
+    coefficients.fill(0);
+
+    for (const Color c : {Color::White, Color::Black}) {
+        const int sign = c == Color::White ? 1 : -1;
+
+        for (const PieceType pt : {PieceType::Pawn,
+                                   PieceType::Knight,
+                                   PieceType::Bishop,
+                                   PieceType::Rook,
+                                   PieceType::Queen,
+                                   PieceType::King}) {
+            Bitboard pieces = pos.get(c, pt);
+            if (pt != PieceType::King)
+                coefficients[kMaterialOffset + to_underlying(pt) - 1] += sign * bit_count(pieces);
+
+            while (pieces) {
+                const auto sq = static_cast<Square>(pop_lsb(pieces));
+                const size_t relativeSq = to_underlying(relative_square(c, sq));
+                coefficients[kPstOffset + ((to_underlying(pt) - 1) * 64) + relativeSq] += sign;
+            }
+        }
+
+        if (bit_count(pos.get(c, PieceType::Bishop)) >= 2)
+            coefficients[kBishopPairOffset] += sign;
+    }
+
+    const AttackMaps maps = compute_attack_maps(pos);
+    for (size_t i = 0; i < kMobilityPieces.size(); ++i) {
+        const auto pt = to_underlying(kMobilityPieces[i]);
+        coefficients[kMobilityOffset + i] =
+            maps.mobility[to_underlying(Color::White)][pt] - maps.mobility[to_underlying(Color::Black)][pt];
+    }
+
+    const ThreatCounts white = threat_counts<Color::White>(pos, maps);
+    const ThreatCounts black = threat_counts<Color::Black>(pos, maps);
+    coefficients[kThreatOffset + 0] = white.byPawn - black.byPawn;
+    coefficients[kThreatOffset + 1] = white.byMinor - black.byMinor;
+    coefficients[kThreatOffset + 2] = white.byRook - black.byRook;
+    coefficients[kThreatOffset + 3] = white.hanging - black.hanging;
+
+    return king_safety_diff(pos, maps);
+}
+
+std::vector<double> initial_weights() {
+    std::vector<double> weights(kNumWeights);
+
+    for (size_t pt = 1; pt <= 5; ++pt)
+        weights[kMaterialOffset + pt - 1] = kPieceValues[pt];
+
+    for (size_t pt = 1; pt <= 6; ++pt) {
+        for (size_t sq = 0; sq < 64; ++sq) {
+            weights[kPstOffset + ((pt - 1) * 64) + sq] =
+                piece_square_bonus(static_cast<PieceType>(pt), Color::White, static_cast<Square>(sq));
+        }
+    }
+
+    for (size_t i = 0; i < kMobilityPieces.size(); ++i)
+        weights[kMobilityOffset + i] = kMobilityWeights[to_underlying(kMobilityPieces[i])];
+
+    weights[kBishopPairOffset] = kBishopPairBonus;
+    weights[kThreatOffset + 0] = kThreatByPawnBonus;
+    weights[kThreatOffset + 1] = kThreatByMinorBonus;
+    weights[kThreatOffset + 2] = kThreatByRookBonus;
+    weights[kThreatOffset + 3] = kHangingPieceBonus;
+    return weights;
+}
+
+Shard load_shard(std::span<const std::string_view> lines, const std::vector<double>& weights) {
+    Shard shard;
+    shard.entries.reserve(lines.size());
+
+    std::array<int, kNumWeights> coefficients{};
+    std::vector<Move> pv;
+
+    for (const std::string_view line : lines) {
+        const auto parsed = parse_line(line);
+        if (!parsed) {
+            ++shard.skipped;
+            continue;
+        }
+
+        Position pos = Position::fromFEN(parsed->first);
+        resolve(pos, kEvalNegInf, kEvalInf, 0, pv);
+        for (const Move move : pv) {
+            UndoInfo undo;
+            pos.makeMove(move, undo);
+        }
+
+        const Eval fixedScore = extract_features(pos, coefficients);
+
+        Entry entry{shard.features.size(), 0, static_cast<int16_t>(fixedScore), parsed->second};
+        double score = fixedScore;
+        for (size_t i = 0; i < kNumWeights; ++i) {
+            if (coefficients[i] == 0)
+                continue;
+            shard.features.push_back({static_cast<uint16_t>(i), static_cast<int16_t>(coefficients[i])});
+            score += weights[i] * coefficients[i];
+            ++entry.featureCount;
+        }
+
+        if (static_cast<Eval>(score) != evaluation(pos))
+            ++shard.mismatches;
+
+        shard.entries.push_back(entry);
+    }
+
+    return shard;
+}
+
+// Runs `fn(shardIndex)` for every shard, one thread per shard.
+template <typename Fn>
+void parallel_for(size_t count, Fn&& fn) {
+    std::vector<std::jthread> workers;
+    workers.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        workers.emplace_back([&fn, i] { fn(i); });
+}
+
+std::vector<Shard> load_dataset(const Options& options, const std::vector<double>& weights) {
+    const MappedFile file(options.datasetPath);
+    const std::vector<std::string_view> lines = split_lines(file.view(), options.maxPositions);
+
+    const size_t threads = std::max<size_t>(1, std::min(options.threads, lines.size()));
+    const size_t perShard = (lines.size() + threads - 1) / threads;
+
+    std::vector<Shard> shards(threads);
+    parallel_for(threads, [&](size_t i) {
+        const size_t begin = std::min(i * perShard, lines.size());
+        const size_t end = std::min(begin + perShard, lines.size());
+        shards[i] = load_shard(std::span(lines).subspan(begin, end - begin), weights);
+    });
+
+    return shards;
+}
+
+double sigmoid(double k, double score) noexcept {
+    return 1.0 / (1.0 + std::pow(10.0, -k * score / 400.0));
+}
+
+double entry_score(const Shard& shard, const Entry& entry, const std::vector<double>& weights) noexcept {
+    double score = entry.fixedScore;
+    for (size_t i = 0; i < entry.featureCount; ++i) {
+        const Feature& f = shard.features[entry.firstFeature + i];
+        score += weights[f.index] * f.coefficient;
+    }
+    return score;
+}
+
+// Mean squared error between the game results and the win probabilities predicted by the evaluation.
+double mean_error(const std::vector<Shard>& shards, const std::vector<double>& weights, double k) {
+    std::vector<double> errors(shards.size());
+    parallel_for(shards.size(), [&](size_t i) {
+        for (const Entry& entry : shards[i].entries) {
+            const double diff = entry.result - sigmoid(k, entry_score(shards[i], entry, weights));
+            errors[i] += diff * diff;
+        }
+    });
+
+    size_t count = 0;
+    for (const Shard& shard : shards)
+        count += shard.entries.size();
+    return std::accumulate(errors.begin(), errors.end(), 0.0) / static_cast<double>(count);
+}
+
+// Finds the sigmoid scaling constant K that best maps the current evaluation to game results.
+double find_k(const std::vector<Shard>& shards, const std::vector<double>& weights) {
+    double lo = 0.1;
+    double hi = 4.0;
+    for (int iteration = 0; iteration < 40; ++iteration) {
+        const double m1 = lo + ((hi - lo) / 3.0);
+        const double m2 = hi - ((hi - lo) / 3.0);
+        if (mean_error(shards, weights, m1) < mean_error(shards, weights, m2))
+            hi = m2;
+        else
+            lo = m1;
+    }
+    return (lo + hi) / 2.0;
+}
+
+std::vector<double> gradient(const std::vector<Shard>& shards, const std::vector<double>& weights, double k) {
+    std::vector<std::vector<double>> partials(shards.size(), std::vector<double>(kNumWeights));
+    parallel_for(shards.size(), [&](size_t i) {
+        const Shard& shard = shards[i];
+        std::vector<double>& partial = partials[i];
+
+        for (const Entry& entry : shard.entries) {
+            const double s = sigmoid(k, entry_score(shard, entry, weights));
+            const double g = (s - entry.result) * s * (1.0 - s);
+            for (size_t j = 0; j < entry.featureCount; ++j) {
+                const Feature& f = shard.features[entry.firstFeature + j];
+                partial[f.index] += g * f.coefficient;
+            }
+        }
+    });
+
+    size_t count = 0;
+    for (const Shard& shard : shards)
+        count += shard.entries.size();
+
+    // d/dw of mean((R - S)^2), with dS/dscore = S(1 - S) * ln(10) * K / 400
+    const double scale = 2.0 * std::log(10.0) * k / 400.0 / static_cast<double>(count);
+    std::vector<double> total(kNumWeights);
+    for (const auto& partial : partials) {
+        for (size_t i = 0; i < kNumWeights; ++i)
+            total[i] += partial[i] * scale;
+    }
+    return total;
+}
+
+// Adam optimizer over the whole dataset, one step per epoch.
+void tune(const std::vector<Shard>& shards, std::vector<double>& weights, double k, const Options& options) {
+    constexpr double kBeta1 = 0.9;
+    constexpr double kBeta2 = 0.999;
+    constexpr double kEpsilon = 1e-8;
+
+    std::vector<double> m(kNumWeights);
+    std::vector<double> v(kNumWeights);
+
+    for (int epoch = 1; epoch <= options.epochs; ++epoch) {
+        const std::vector<double> grad = gradient(shards, weights, k);
+        for (size_t i = 0; i < kNumWeights; ++i) {
+            m[i] = (kBeta1 * m[i]) + ((1.0 - kBeta1) * grad[i]);
+            v[i] = (kBeta2 * v[i]) + ((1.0 - kBeta2) * grad[i] * grad[i]);
+            const double mHat = m[i] / (1.0 - std::pow(kBeta1, epoch));
+            const double vHat = v[i] / (1.0 - std::pow(kBeta2, epoch));
+            weights[i] -= options.learningRate * mHat / (std::sqrt(vHat) + kEpsilon);
+        }
+
+        if (epoch % 10 == 0 || epoch == options.epochs)
+            std::cerr << std::format("epoch {} error {:.6f}\n", epoch, mean_error(shards, weights, k));
+    }
+}
+
+int rounded(double weight) noexcept {
+    return static_cast<int>(std::lround(weight));
+}
+
+// Emits `values` as an initializer list with one entry per line, each followed by the name of its piece type.
+std::string per_piece_to_string(std::string_view type, std::string_view name, const std::array<int, 7>& values) {
+    constexpr std::array<std::string_view, 7> kNames = {"None", "Pawn", "Knight", "Bishop", "Rook", "Queen", "King"};
+
+    size_t width = 0;
+    for (const int value : values)
+        width = std::max(width, std::to_string(value).size() + 1);
+
+    std::string out = std::format("inline constexpr std::array<{}, to_underlying(PieceType::Count)> {} = {{\n", type, name);
+    for (size_t i = 0; i < values.size(); ++i) {
+        std::string value = std::to_string(values[i]) + ",";
+        value.resize(width + 2, ' ');
+        out += std::format("    {}// {}\n", value, kNames[i]);
+    }
+    out += "};\n";
+    return out;
+}
+
+// Emits a piece-square table as an 8x8 grid, rank 1 (a1-h1) first, matching the layout the tables are indexed in.
+std::string pst_to_string(std::string_view name, std::span<const double> weights) {
+    std::string out = std::format("inline constexpr std::array<int, 64> {} = {{\n", name);
+    for (size_t rank = 0; rank < 8; ++rank) {
+        out += "   ";
+        for (size_t file = 0; file < 8; ++file) {
+            const int value = rounded(weights[(rank * 8) + file]);
+            std::string cell = (value >= 0 ? "+" : "") + std::to_string(value) + ",";
+            cell.insert(0, 5 - std::min<size_t>(cell.size(), 5), ' ');
+            out += cell;
+        }
+        out += "\n";
+    }
+    out += "};\n";
+    return out;
+}
+
+std::string weights_to_string(const std::vector<double>& weights) {
+    std::string out{};
+    out += "// Auto generated by tools/tune_eval.cpp\n\n";
+    out += "#pragma once\n";
+    out += "#include <array>\n";
+    out += "#include <cstdint>\n\n";
+    out += "#include \"types.h\"\n\n";
+
+    std::array<int, 7> pieceValues = {0, 0, 0, 0, 0, 0, kPieceValues[to_underlying(PieceType::King)]};
+    for (size_t pt = 1; pt <= 5; ++pt)
+        pieceValues[pt] = rounded(weights[kMaterialOffset + pt - 1]);
+    out += per_piece_to_string("int16_t", "kPieceValues", pieceValues) + "\n";
+
+    std::array<int, 7> mobilityWeights{};
+    for (size_t i = 0; i < kMobilityPieces.size(); ++i)
+        mobilityWeights[to_underlying(kMobilityPieces[i])] = rounded(weights[kMobilityOffset + i]);
+    out += per_piece_to_string("int", "kMobilityWeights", mobilityWeights) + "\n";
+
+    constexpr std::array<std::string_view, 6> kPstNames = {
+        "kPawnPST", "kKnightPST", "kBishopPST", "kRookPST", "kQueenPST", "kKingPST"
+    };
+    out += "// clang-format off\n";
+    for (size_t i = 0; i < kPstNames.size(); ++i) {
+        const std::span<const double> table(weights.data() + kPstOffset + (i * 64), 64);
+        out += pst_to_string(kPstNames[i], table) + (i + 1 < kPstNames.size() ? "\n" : "");
+    }
+    out += "// clang-format on\n\n";
+
+    out += std::format("inline constexpr int kBishopPairBonus = {};\n\n", rounded(weights[kBishopPairOffset]));
+
+    constexpr std::array<std::pair<std::string_view, std::string_view>, 4> kThreats = {{
+        {"kThreatByPawnBonus", "Per enemy non-pawn piece attacked by a pawn"},
+        {"kThreatByMinorBonus", "Per enemy rook or queen attacked by a knight or bishop"},
+        {"kThreatByRookBonus", "Per enemy queen attacked by a rook"},
+        {"kHangingPieceBonus", "Per enemy non-pawn piece attacked and not defended"},
+    }};
+
+    std::array<std::string, kThreats.size()> threatLines;
+    size_t width = 0;
+    for (size_t i = 0; i < kThreats.size(); ++i) {
+        threatLines[i] =
+            std::format("inline constexpr int {} = {};", kThreats[i].first, rounded(weights[kThreatOffset + i]));
+        width = std::max(width, threatLines[i].size());
+    }
+
+    out += "// Threats: bonuses for attacking enemy pieces with lesser pieces, or enemy pieces that are undefended\n";
+    for (size_t i = 0; i < kThreats.size(); ++i) {
+        threatLines[i].resize(width + 2, ' ');
+        out += std::format("{}// {}\n", threatLines[i], kThreats[i].second);
+    }
+    return out;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1UL, std::stoul(argv[++i]));
+        }
+        else if (arg == "--epochs" && i + 1 < argc) {
+            options.epochs = std::stoi(argv[++i]);
+        }
+        else if (arg == "--learning-rate" && i + 1 < argc) {
+            options.learningRate = std::stod(argv[++i]);
+        }
+        else if (arg == "--positions" && i + 1 < argc) {
+            options.maxPositions = std::stoul(argv[++i]);
+        }
+        else if (arg == "--output" && i + 1 < argc) {
+            options.outputPath = argv[++i];
+        }
+        else if (!arg.starts_with("--") && options.datasetPath.empty()) {
+            options.datasetPath = arg;
+        }
+        else {
+            throw std::invalid_argument("Unknown argument: " + std::string(arg));
+        }
+    }
+
+    if (options.datasetPath.empty()) {
+        throw std::invalid_argument(
+            "Usage: tune_eval <dataset> [--threads N] [--epochs N] [--learning-rate X] [--positions N] [--output FILE]"
+        );
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = parse_options(argc, argv);
+        engine::init_engine();
+
+        std::vector<double> weights = initial_weights();
+        const std::vector<Shard> shards = load_dataset(options, weights);
+
+        size_t positions = 0;
+        size_t skipped = 0;
+        size_t mismatches = 0;
+        for (const Shard& shard : shards) {
+            positions += shard.entries.size();
+            skipped += shard.skipped;
+            mismatches += shard.mismatches;
+        }
+
+        std::cerr << std::format("Loaded {} positions ({} skipped) on {} threads\n", positions, skipped, shards.size());
+        if (positions == 0)
+            throw std::runtime_error("No usable positions in " + options.datasetPath);
+        if (mismatches != 0)
+            throw std::runtime_error(std::format("Feature extraction disagrees with evaluation() on {} positions", mismatches));
+
+        const double k = find_k(shards, weights);
+        std::cerr << std::format("K = {:.4f}, initial error {:.6f}\n", k, mean_error(shards, weights, k));
+
+        tune(shards, weights, k, options);
+
+        // Only touch the output once tuning succeeded, so a failed run never leaves a truncated header behind
+        const std::string out = weights_to_string(weights);
+        if (options.outputPath.empty()) {
+            std::cout << out;
+        }
+        else {
+            std::ofstream file(options.outputPath);
+            file << out;
+            if (!file)
+                throw std::runtime_error("Failed to write " + options.outputPath);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error tuning evaluation: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}